@@ -0,0 +1,163 @@
+#pragma once
+
+/// @file approx_hull.h
+/// @brief approximate hull of a huge point set in one pass with a few kilobytes of memory
+///
+/// the hull is sampled in k directions spread evenly around the circle: for each direction the input point farthest along it is
+/// kept, and the result is the hull of those k points, so every point it returns is an input point on the boundary of the exact hull
+/// every input point lies inside the k support lines, and the farthest such a point can be from the result is the distance from a
+/// corner of the support lines to the result, so the error is known exactly after the pass and it is at most diameter*tan(pi/k)/2
+/// k is the dial between speed and error: directions_for() gives the k for an error relative to the diameter
+///
+/// most points are inside the polygon of the extreme points found so far in 8 of the directions and cannot move any of them,
+/// those are rejected with 8 orientation tests, only the others are compared with all k directions
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "hull_point.h"
+#include "ks_hull.h"
+
+template <class P = Vector2>
+class approx_hull
+{
+public:
+    /// @param directions number of directions sampled, rounded up to a multiple of 8
+    explicit approx_hull(int directions = 64)
+    {
+        int k = std::max(8, (directions + 7) / 8 * 8);
+        ux.resize(k);
+        uy.resize(k);
+        for (int j = 0; j < k; j++)
+        {
+            ux[j] = std::cos(2 * M_PI * j / k);
+            uy[j] = std::sin(2 * M_PI * j / k);
+        }
+        support.resize(k);
+        extreme.resize(k);
+        clear();
+    }
+
+    /// @brief number of directions that keeps every point within eps*diameter of the result
+    static int directions_for(double eps)
+    {
+        /// the error is at most diameter*tan(pi/k)/2
+        return (int)std::ceil(M_PI / std::atan(2 * std::max(eps, 1e-9)));
+    }
+
+    /// @brief number of directions sampled
+    int directions() const { return (int)ux.size(); }
+
+    /// @brief number of points which were compared with all the directions (the others were rejected by the filter)
+    size_t tested = 0;
+
+    /// @brief forgets the points added so far
+    void clear()
+    {
+        for (size_t j = 0; j < support.size(); j++)
+            support[j] = -INFINITY;
+        count = 0;
+        tested = 0;
+    }
+
+    /// @brief adds points, the input can be given in as many chunks as needed
+    void add(const P *pts, size_t n)
+    {
+        int k = directions(), step = k / 8;
+        size_t i = 0;
+        /// the first points go through the full update until the filter has its 8 points
+        for (; i < n && count == 0; i++)
+            update(pts[i]);
+        for (; i < n; i++)
+        {
+            const P &p = pts[i];
+            /// strictly inside the polygon of the 8 extreme points means it is inside the hull of what was seen, so no support
+            /// can grow; an edge of two equal points is skipped and fewer than 3 edges never rejects anything
+            int edges = 0;
+            bool inside = true;
+            for (int f = 0; f < 8 && inside; f++)
+            {
+                const P &a = extreme[f * step], &b = extreme[(f + 1) % 8 * step];
+                if (a.x == b.x && a.y == b.y)
+                    continue;
+                edges++;
+                /// the directions turn counterclockwise, so the inside is on the left of a->b: orientation 2 in screen terms
+                inside = hull_orientation(a, b, p) == 2;
+            }
+            if (!inside || edges < 3)
+                update(p);
+        }
+    }
+
+    /// @brief computes the hull of the extreme points, in the engine order
+    /// @return the largest distance an added point can have from the hull
+    double hull(std::vector<P> &out)
+    {
+        out.clear();
+        if (count == 0)
+            return 0;
+        int k = directions();
+        std::vector<P> candidates(extreme.begin(), extreme.end());
+        out.resize(k);
+        out.resize(ks_hull(candidates.data(), k, out.data(), ws));
+
+        /// corner j is where the support lines of directions j and j+1 meet, every point is inside the polygon of the corners and
+        /// its distance to the hull is at most the distance of the farthest corner to the segment of the two extreme points
+        double error = 0;
+        for (int j = 0; j < k; j++)
+        {
+            int l = (j + 1) % k;
+            double det = ux[j] * uy[l] - uy[j] * ux[l];
+            double cx = (support[j] * uy[l] - uy[j] * support[l]) / det;
+            double cy = (ux[j] * support[l] - support[j] * ux[l]) / det;
+            error = std::max(error, segment_distance(cx, cy, extreme[j], extreme[l]));
+        }
+        return error;
+    }
+
+    /// @brief the approximate hull of pts[0..n) in one call
+    /// @return the largest distance a point of the input can have from the hull
+    double run(const P *pts, size_t n, std::vector<P> &out)
+    {
+        clear();
+        add(pts, n);
+        return hull(out);
+    }
+
+private:
+    /// @brief compares p with every direction
+    void update(const P &p)
+    {
+        int k = directions();
+        double x = (double)p.x, y = (double)p.y;
+        for (int j = 0; j < k; j++)
+        {
+            double d = ux[j] * x + uy[j] * y;
+            if (d > support[j])
+            {
+                support[j] = d;
+                extreme[j] = p;
+            }
+        }
+        count++;
+        tested++;
+    }
+
+    /// @brief distance from (x,y) to the segment a-b
+    static double segment_distance(double x, double y, const P &a, const P &b)
+    {
+        double ax = (double)a.x, ay = (double)a.y, dx = (double)b.x - ax, dy = (double)b.y - ay;
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? ((x - ax) * dx + (y - ay) * dy) / len2 : 0;
+        t = std::min(1.0, std::max(0.0, t));
+        return std::hypot(x - ax - t * dx, y - ay - t * dy);
+    }
+
+    /// @brief the directions, direction j is at the angle 2*pi*j/k
+    std::vector<double> ux, uy;
+    /// @brief largest projection on each direction so far and the point which has it
+    std::vector<double> support;
+    std::vector<P> extreme;
+    size_t count = 0;
+    ks_workspace_of<P> ws;
+};
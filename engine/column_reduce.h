@@ -0,0 +1,195 @@
+#pragma once
+
+/// @file column_reduce.h
+/// @brief cuts a dense input down to a few candidates before the hull engines, with the highest and lowest point of x-columns
+///
+/// the points are put in K columns of equal width and every column keeps its highest and its lowest point; that is one scan
+/// and at most 2K points, but it is not enough on its own: a corner of the hull is not always the extreme of its column (the
+/// leftmost point of the input sits in the first column with points above and below it further right, and a steep edge can
+/// have a higher point of the same column next to its corner), so a second scan repairs it
+/// the hull of the column extremes is inside the hull of the input, and any point which is not strictly outside it cannot be a
+/// corner; within a column that hull's upper and lower chains are at their lowest and highest at the ends of the column, so a
+/// point between those two heights is inside with two comparisons, only the few points near the top and bottom of their column
+/// are located on the hull with hull_query
+/// the candidates (the extremes and the points outside their hull) have exactly the hull of the input, for uniform inputs they
+/// are a few percent of it
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "hull.h"
+#include "hull_merge.h"
+#include "hull_query.h"
+
+/// @brief what column_reduce() did
+struct column_reduce_stats
+{
+    /// @brief number of input points
+    int points = 0;
+    /// @brief number of columns used
+    int columns = 0;
+    /// @brief column extremes kept by the first scan
+    int extremes = 0;
+    /// @brief points added back by the repair scan (outside the hull of the extremes)
+    int repaired = 0;
+
+    /// @brief candidates over input points, 1 means nothing was cut
+    double ratio() const { return points ? (double)(extremes + repaired) / points : 1.0; }
+};
+
+/// @brief scratch buffers of column_reduce()
+template <class P>
+struct column_reduce_workspace_of
+{
+    std::vector<int> top, bottom, local, candidates;
+    std::vector<P> extremes, hull;
+    std::vector<double> upper_cut, lower_cut;
+    ks_index_workspace_of<P> ks;
+    hull_query<P> query;
+    /// @brief for the engine which runs on the candidates (column_reduced_hull())
+    ks_workspace_of<P> engine;
+};
+
+/// @brief the number of columns column_reduce() uses by default for n points
+inline int column_reduce_columns(int n) { return std::max(16, std::min(n / 64, 1 << 16)); }
+
+/// @brief finds the points which can be on the hull of pts: the highest and lowest point of every column plus the points outside
+/// the hull of those
+/// @param columns number of columns, 0 picks column_reduce_columns(n)
+/// @param out receives the indices of the candidates, it needs room for n of them
+/// @param stats receives the reduction, can be nullptr
+/// @return number of candidates, their hull is the hull of pts
+template <class P>
+inline int column_reduce(const P *pts, int n, int columns, int *out, column_reduce_workspace_of<P> &ws,
+                         column_reduce_stats *stats = nullptr)
+{
+    column_reduce_stats st;
+    st.points = n;
+    int k = columns > 0 ? columns : column_reduce_columns(n);
+    double xmin = INFINITY, xmax = -INFINITY;
+    for (int i = 0; i < n; i++)
+    {
+        xmin = std::min(xmin, (double)pts[i].x);
+        xmax = std::max(xmax, (double)pts[i].x);
+    }
+    if (n <= 2 * k || !(xmax > xmin))
+    {
+        /// nothing to gain (or a vertical line, which has a single column)
+        for (int i = 0; i < n; i++)
+            out[i] = i;
+        st.extremes = n;
+        if (stats)
+            *stats = st;
+        return n;
+    }
+    st.columns = k;
+    double scale = k / (xmax - xmin), width = (xmax - xmin) / k;
+    auto column = [&](const P &p)
+    { return std::min(k - 1, (int)(((double)p.x - xmin) * scale)); };
+
+    /// first scan: the extremes of every column (screen coordinates, top is the smallest y)
+    ws.top.assign(k, -1);
+    ws.bottom.assign(k, -1);
+    for (int i = 0; i < n; i++)
+    {
+        int c = column(pts[i]);
+        int &t = ws.top[c], &b = ws.bottom[c];
+        if (t < 0)
+            t = b = i;
+        else if (pts[i].y < pts[t].y)
+            t = i;
+        else if (pts[i].y > pts[b].y)
+            b = i;
+    }
+    int m = 0;
+    for (int c = 0; c < k; c++)
+    {
+        if (ws.top[c] < 0)
+            continue;
+        out[m++] = ws.top[c];
+        if (ws.bottom[c] != ws.top[c])
+            out[m++] = ws.bottom[c];
+    }
+    st.extremes = m;
+
+    /// the hull of the extremes
+    ws.extremes.resize(m);
+    for (int i = 0; i < m; i++)
+        ws.extremes[i] = pts[out[i]];
+    ws.local.resize(m);
+    int h = ks_hull_indices(ws.extremes.data(), m, ws.local.data(), ws.ks);
+    ws.hull.resize(h);
+    for (int i = 0; i < h; i++)
+        ws.hull[i] = ws.extremes[ws.local[i]];
+    ws.query.build(ws.hull.data(), h);
+
+    /// the heights between which a point of a column is inside that hull, a column which reaches past the hull gets no heights
+    /// (all its points are located); the ends and the heights are widened a little so rounding cannot let an outside point in
+    ws.upper_cut.assign(k, INFINITY);
+    ws.lower_cut.assign(k, -INFINITY);
+    if (h >= 3)
+    {
+        hull_chain<P> up(ws.hull.data(), h, false), down(ws.hull.data(), h, true);
+        double hx0 = ws.hull[0].x, hx1 = ws.hull[up.right_top].x;
+        auto height = [](const hull_chain<P> &chain, double x)
+        {
+            int lo = 0, hi = chain.size() - 2;
+            while (lo < hi)
+            {
+                int mid = (lo + hi + 1) / 2;
+                if (chain[mid].x <= x)
+                    lo = mid;
+                else
+                    hi = mid - 1;
+            }
+            P a = chain[lo], b = chain[lo + 1];
+            return a.y + ((double)b.y - a.y) * (x - a.x) / ((double)b.x - a.x);
+        };
+        double slack = 1e-6 * width + 1e-12 * std::max(std::abs(xmin), std::abs(xmax));
+        for (int c = 0; c < k; c++)
+        {
+            double x0 = xmin + c * width - slack, x1 = xmin + (c + 1) * width + slack;
+            if (x0 <= hx0 || x1 >= hx1)
+                continue;
+            double u = std::max(height(up, x0), height(up, x1)), l = std::min(height(down, x0), height(down, x1));
+            double margin = 1e-6 * std::abs(l - u) + 1e-12 * std::max(std::abs(u), std::abs(l));
+            ws.upper_cut[c] = u + margin;
+            ws.lower_cut[c] = l - margin;
+        }
+    }
+
+    /// second scan: the points outside the hull of the extremes (the extremes themselves are on it, not outside)
+    for (int i = 0; i < n; i++)
+    {
+        int c = column(pts[i]);
+        double y = pts[i].y;
+        if (y > ws.upper_cut[c] && y < ws.lower_cut[c])
+            continue;
+        if (ws.query.locate(pts[i]) == hull_outside)
+            out[m++] = i;
+    }
+    st.repaired = m - st.extremes;
+    if (stats)
+        *stats = st;
+    return m;
+}
+
+/// @brief computes the hull of pts with an engine, on the candidates of column_reduce()
+///
+/// same hull and order as compute_hull() (when several points are at the same corner the one returned can differ)
+/// @param out receives the hull, it needs room for n points
+/// @param columns number of columns, 0 picks column_reduce_columns(n)
+/// @param stats receives the reduction, can be nullptr
+/// @return number of points in the hull
+template <class P>
+inline int column_reduced_hull(hull_engine engine, const P *pts, int n, P *out, column_reduce_workspace_of<P> &ws,
+                               int columns = 0, column_reduce_stats *stats = nullptr)
+{
+    std::vector<int> &ids = ws.candidates;
+    ids.resize(std::max(n, 0));
+    int m = column_reduce(pts, n, columns, ids.data(), ws, stats);
+    ws.extremes.resize(m);
+    for (int i = 0; i < m; i++)
+        ws.extremes[i] = pts[ids[i]];
+    return compute_hull(engine, ws.extremes.data(), m, out, ws.engine);
+}
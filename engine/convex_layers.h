@@ -0,0 +1,289 @@
+#pragma once
+
+/// @file convex_layers.h
+/// @brief convex layers (onion peeling): the depth of every point, 0 for the points on the hull, 1 for the hull of the rest...
+///
+/// peeling by running an engine again on what is left costs O(n) per layer, and uniform inputs have about n^(2/3) layers
+/// here the points are sorted once and the upper and the lower hull are kept in two trees which only store, for every node,
+/// the bridge between the hulls of its two halves (Overmars and van Leeuwen, without the lists of the hulls)
+/// a layer is read from the trees in O(h log n), and removing it only recomputes the bridges above the removed points, each bridge
+/// is a binary search over the left half with a tangent search in the right half at every step, O(log^2 n)
+/// so all the layers take O(n log^3 n) in the worst case instead of O(n^2)
+///
+/// a layer is every point on the boundary of the hull of what is left, the collinear points and the duplicates included,
+/// so two copies of a point always have the same depth (the engines drop those points from their hulls)
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "hull_point.h"
+
+/// @brief the upper (or lower) hull of the columns of points which are left, for the convex layers
+///
+/// the leaves are the columns (the points with the same x), a column is represented by its top point (bottom one for Lower)
+/// an internal node stores the bridge between the hulls of its two children; the hull of a node is then the hull of the left child
+/// up to the left end of the bridge and the hull of the right child from its right end, so it never needs to be stored
+template <class P, bool Lower>
+class convex_layer_tree
+{
+public:
+    /// @param sorted the points sorted by x
+    /// @param column column of every point
+    /// @param columns number of columns
+    void build(const P *sorted, const int *column, int columns)
+    {
+        pts = sorted;
+        col = column;
+        leaves = 1;
+        while (leaves < columns)
+            leaves *= 2;
+        left.assign(2 * leaves, -1);
+        right.assign(2 * leaves, -1);
+        state.assign(2 * leaves, empty);
+        stamp.assign(2 * leaves, 0);
+        dirty.clear();
+    }
+
+    /// @brief sets the point representing a column, -1 if the column is empty (update() must be called after)
+    void set_column(int c, int point)
+    {
+        int v = leaves + c;
+        left[v] = right[v] = point;
+        state[v] = point >= 0 ? leaf : empty;
+        /// the ancestors of a marked node are already marked
+        for (v >>= 1; v > 0 && stamp[v] != generation; v >>= 1)
+        {
+            stamp[v] = generation;
+            dirty.push_back(v);
+        }
+    }
+
+    /// @brief recomputes the bridges above the columns which changed
+    void update()
+    {
+        /// the children of a node have bigger indices, so decreasing order does them first
+        std::sort(dirty.begin(), dirty.end(), [](int a, int b)
+                  { return a > b; });
+        for (int v : dirty)
+        {
+            int a = 2 * v, b = 2 * v + 1;
+            if (state[a] == empty)
+                state[v] = state[b] == empty ? empty : only_right;
+            else if (state[b] == empty)
+                state[v] = only_left;
+            else
+            {
+                state[v] = both;
+                bridge(a, b, left[v], right[v]);
+            }
+        }
+        dirty.clear();
+        generation++;
+    }
+
+    /// @brief calls emit(point) for every point of the hull, from left to right
+    template <class F>
+    void walk(F emit) const { walk(1, 0, leaves, 0, leaves - 1, emit); }
+
+private:
+    enum : uint8_t
+    {
+        empty,
+        leaf,
+        only_left,
+        only_right,
+        both
+    };
+    static const int above = Lower ? 2 : 1;
+    static const int below = Lower ? 1 : 2;
+
+    /// @brief the first point of the hull of node v touched by the tangent from p (p is left of all the points of v)
+    int tangent(const P &p, int v) const
+    {
+        while (true)
+        {
+            switch (state[v])
+            {
+            case leaf:
+                return left[v];
+            case only_left:
+                v = 2 * v;
+                break;
+            case only_right:
+                v = 2 * v + 1;
+                break;
+            default:
+                /// the right end of the bridge above the line p->left end: the tangent touches at it or after it
+                v = hull_orientation(p, pts[left[v]], pts[right[v]]) == above ? 2 * v + 1 : 2 * v;
+            }
+        }
+    }
+
+    /// @brief the bridge between the hulls of a and b (all the points of a are left of the points of b)
+    ///
+    /// the left end is the last point p of the hull of a whose next point is not below the line from p to its tangent to b, the
+    /// bridge of a node is an edge of its hull so it tells in which child that point is, and the same point is the left end of
+    /// the bridge between that child and b; with collinear points both ends are the inner ones, so they stay on the hull
+    void bridge(int a, int b, int &l, int &r) const
+    {
+        while (state[a] != leaf)
+        {
+            if (state[a] == only_left)
+                a = 2 * a;
+            else if (state[a] == only_right)
+                a = 2 * a + 1;
+            else
+            {
+                const P &p = pts[left[a]];
+                int t = tangent(p, b);
+                a = hull_orientation(p, pts[t], pts[right[a]]) != below ? 2 * a + 1 : 2 * a;
+            }
+        }
+        l = left[a];
+        r = tangent(pts[l], b);
+    }
+
+    /// @brief emits the points of the hull of node v (columns [lo, hi)) which are in the columns [from, to]
+    template <class F>
+    void walk(int v, int lo, int hi, int from, int to, F &emit) const
+    {
+        if (state[v] == empty || from > to || to < lo || from >= hi)
+            return;
+        int mid = (lo + hi) / 2;
+        switch (state[v])
+        {
+        case leaf:
+            emit(left[v]);
+            break;
+        case only_left:
+            walk(2 * v, lo, mid, from, to, emit);
+            break;
+        case only_right:
+            walk(2 * v + 1, mid, hi, from, to, emit);
+            break;
+        default:
+            walk(2 * v, lo, mid, from, std::min(to, col[left[v]]), emit);
+            walk(2 * v + 1, mid, hi, std::max(from, col[right[v]]), to, emit);
+        }
+    }
+
+    const P *pts = nullptr;
+    const int *col = nullptr;
+    int leaves = 1;
+    /// @brief bridge of an internal node (point indices), the point of a leaf in both
+    std::vector<int> left, right;
+    std::vector<uint8_t> state;
+    std::vector<int> dirty;
+    std::vector<unsigned> stamp;
+    unsigned generation = 1;
+};
+
+/// @brief computes the convex layers of pts[0..n)
+/// @param depth receives the layer of every point, 0 for the outer hull
+/// @return number of layers
+template <class P>
+inline int convex_layers(const P *pts, int n, int *depth)
+{
+    if (n == 0)
+        return 0;
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [pts](int a, int b)
+              { return pts[a].x < pts[b].x || (pts[a].x == pts[b].x && pts[a].y < pts[b].y); });
+    std::vector<P> sorted(n);
+    std::vector<int> column(n), layer(n, -1);
+    /// the points which are left in column c are sorted[begin[c] .. end[c])
+    std::vector<int> begin, end;
+    for (int i = 0; i < n; i++)
+    {
+        sorted[i] = pts[order[i]];
+        if (i == 0 || sorted[i].x != sorted[i - 1].x)
+        {
+            begin.push_back(i);
+            end.push_back(i);
+        }
+        column[i] = (int)begin.size() - 1;
+        end.back() = i + 1;
+    }
+    int columns = (int)begin.size();
+
+    /// the top of a column is its first point and the bottom its last one (screen coordinates, y grows downwards)
+    convex_layer_tree<P, false> upper;
+    convex_layer_tree<P, true> lower;
+    upper.build(sorted.data(), column.data(), columns);
+    lower.build(sorted.data(), column.data(), columns);
+    for (int c = 0; c < columns; c++)
+    {
+        upper.set_column(c, begin[c]);
+        lower.set_column(c, end[c] - 1);
+    }
+    upper.update();
+    lower.update();
+
+    int left = n, layers = 0, first = 0, last = columns - 1;
+    std::vector<int> taken;
+    while (left > 0)
+    {
+        taken.clear();
+        auto take = [&](int i)
+        {
+            if (layer[i] < 0)
+            {
+                layer[i] = layers;
+                taken.push_back(i);
+            }
+        };
+        /// the copies of a point are next to it in the sorted order, they are on the boundary too
+        auto take_copies = [&](int i)
+        {
+            take(i);
+            for (int j = i + 1; j < n && sorted[j].x == sorted[i].x && sorted[j].y == sorted[i].y; j++)
+                take(j);
+            for (int j = i - 1; j >= 0 && sorted[j].x == sorted[i].x && sorted[j].y == sorted[i].y; j--)
+                take(j);
+        };
+        upper.walk(take_copies);
+        lower.walk(take_copies);
+        /// the leftmost and the rightmost columns are vertical edges, all their points are on the boundary
+        for (int i = begin[first]; i < end[first]; i++)
+            take(i);
+        for (int i = begin[last]; i < end[last]; i++)
+            take(i);
+        left -= (int)taken.size();
+        layers++;
+
+        /// only the ends of a column (and their copies) can be on a hull, so what is left of a column stays a range
+        for (int i : taken)
+        {
+            int c = column[i];
+            int b = begin[c], e = end[c];
+            while (begin[c] < end[c] && layer[begin[c]] >= 0)
+                begin[c]++;
+            while (end[c] > begin[c] && layer[end[c] - 1] >= 0)
+                end[c]--;
+            if (begin[c] != b)
+                upper.set_column(c, begin[c] < end[c] ? begin[c] : -1);
+            if (end[c] != e || begin[c] == end[c])
+                lower.set_column(c, begin[c] < end[c] ? end[c] - 1 : -1);
+        }
+        upper.update();
+        lower.update();
+        while (first <= last && begin[first] == end[first])
+            first++;
+        while (last >= first && begin[last] == end[last])
+            last--;
+    }
+    for (int i = 0; i < n; i++)
+        depth[order[i]] = layer[i];
+    return layers;
+}
+
+/// @brief convex layers of the points, the layer of every point (0 for the outer hull)
+template <class P>
+inline std::vector<int> convex_layers(const std::vector<P> &points)
+{
+    std::vector<int> depth(points.size());
+    convex_layers(points.data(), (int)points.size(), depth.data());
+    return depth;
+}
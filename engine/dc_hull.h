@@ -0,0 +1,152 @@
+#pragma once
+
+/// @file dc_hull.h
+/// @brief parallel divide and conquer engine: hulls of x-slabs computed on a thread pool and merged pairwise
+
+#include <vector>
+#include <algorithm>
+#include "hull_point.h"
+#include "ks_hull.h"
+#include "hull_merge.h"
+#include "thread_pool.h"
+
+/// @brief computes big hulls on a thread pool
+///
+/// the points are split into x-slabs, every slab is hulled with ks_hull() on its own worker and the slab hulls are merged
+/// two by two with hull_merge() (a reduction tree, every level of it is merged in parallel too)
+template <class P = Vector2>
+class dc_hull
+{
+public:
+    /// @param threads number of threads, 0 means one per hardware thread
+    explicit dc_hull(unsigned threads = 0) : pool(threads) {}
+
+    /// @brief slabs are not made smaller than this, below it the split costs more than it saves
+    int min_slab = 1 << 14;
+
+    /// @brief computes the convex hull of the points, same output as ks_hull()
+    /// @param out receives the hull, it needs room for n points
+    /// @return number of points in the hull
+    int run(const P *points, int n, P *out)
+    {
+        const P *hull = nullptr;
+        int h = solve(points, n, plain, hull);
+        std::copy(hull, hull + h, out);
+        return h;
+    }
+
+    /// @brief computes the convex hull of the points and gives it as indices into points, same order as run()
+    /// @param out receives the indices of the hull points, it needs room for n of them
+    /// @return number of points in the hull
+    int run_indices(const P *points, int n, int *out)
+    {
+        const hull_indexed_of<P> *hull = nullptr;
+        int h = solve(points, n, indexed, hull);
+        for (int i = 0; i < h; i++)
+            out[i] = hull[i].id;
+        return h;
+    }
+
+    /// @brief computes the convex hull of the points
+    /// @return the points on the hull
+    std::vector<P> run(const std::vector<P> &points)
+    {
+        std::vector<P> out(points.size());
+        out.resize(run(points.data(), (int)points.size(), out.data()));
+        return out;
+    }
+
+    /// @brief computes the convex hull of the points and gives it as indices into them
+    /// @return the indices of the points on the hull
+    std::vector<int> run_indices(const std::vector<P> &points)
+    {
+        std::vector<int> out(points.size());
+        out.resize(run_indices(points.data(), (int)points.size(), out.data()));
+        return out;
+    }
+
+    /// @brief number of threads
+    unsigned threads() const { return pool.size(); }
+
+private:
+    /// @brief the buffers of the slabs for one work point type (the points, or the points with their index)
+    template <class W>
+    struct buffers
+    {
+        std::vector<ks_workspace_of<W>> workspaces;
+        std::vector<W> work;
+        std::vector<W> hulls[2];
+    };
+
+    /// @brief hulls the slabs and merges them on the work points W
+    /// @param hull receives where the hull is (inside b)
+    /// @return number of points in the hull
+    template <class W>
+    int solve(const P *points, int n, buffers<W> &b, const W *&hull)
+    {
+        if (n <= 0)
+            return 0;
+        /// a power of two of slabs, a few per thread so a slow slab does not hold the others
+        int slabs = 1;
+        while (slabs < 4 * (int)pool.size() && n / (2 * slabs) >= min_slab)
+            slabs *= 2;
+
+        b.workspaces.resize(pool.size());
+        b.work.resize(n);
+        for (int i = 0; i < n; i++)
+            ks_input<P, W>::load(points, i, b.work[i]);
+        starts.resize(slabs + 1);
+        for (int i = 0; i <= slabs; i++)
+            starts[i] = (int)((long long)n * i / slabs);
+        auto by_x = [](const W &a, const W &c)
+        { return a.x < c.x; };
+        for (int i = 1; i < slabs; i++)
+        {
+            starts[i] = std::max(starts[i], starts[i - 1]);
+            if (starts[i] >= n)
+            {
+                starts[i] = n;
+                continue;
+            }
+            std::nth_element(b.work.begin() + starts[i - 1], b.work.begin() + starts[i], b.work.end(), by_x);
+            /// the points with the same x as the split all go to the left slab, so the slabs do not overlap
+            typename hull_point_traits<W>::coord x = b.work[starts[i]].x;
+            starts[i] = (int)(std::partition(b.work.begin() + starts[i], b.work.end(), [x](const W &p)
+                                             { return p.x == x; }) -
+                              b.work.begin());
+        }
+
+        b.hulls[0].resize(n);
+        b.hulls[1].resize(n);
+        sizes.resize(slabs);
+        pool.parallel_for(slabs, 1, [&](unsigned worker, size_t begin, size_t end)
+                          {
+            for (size_t i = begin; i < end; i++)
+                sizes[i] = ks_hull(b.work.data() + starts[i], starts[i + 1] - starts[i], b.hulls[0].data() + starts[i], b.workspaces[worker]); });
+
+        /// merged hull of slabs i..i+2*step goes where the hull of slab i was, in the other buffer
+        int cur = 0;
+        for (int step = 1; step < slabs; step *= 2)
+        {
+            W *from = b.hulls[cur].data();
+            W *to = b.hulls[1 - cur].data();
+            pool.parallel_for(slabs / (2 * step), 1, [&](unsigned, size_t begin, size_t end)
+                              {
+                for (size_t pair = begin; pair < end; pair++)
+                {
+                    int i = (int)pair * 2 * step;
+                    int j = i + step;
+                    sizes[i] = hull_merge(from + starts[i], sizes[i], from + starts[j], sizes[j], to + starts[i]);
+                } });
+            cur = 1 - cur;
+        }
+        hull = b.hulls[cur].data();
+        return sizes[0];
+    }
+
+    hull_thread_pool pool;
+    buffers<P> plain;
+    buffers<hull_indexed_of<P>> indexed;
+    std::vector<int> starts;
+    std::vector<int> sizes;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+/// @file hull.h
+/// @brief one entry point for all the hull engines
+
+#include <vector>
+#include "hull_point.h"
+#include "jarvis_hull.h"
+#include "ks_hull.h"
+#include "sorted_hull.h"
+#include "tiny_hull.h"
+
+/// @brief the algorithm used to compute a hull
+enum class hull_engine
+{
+    /// @brief picks the cheapest engine for the number of points
+    automatic,
+    /// @brief jarvis march, O(n h) but with a very small constant
+    jarvis,
+    /// @brief Kirkpatrick-Seidel, O(n log h)
+    kirkpatrick_seidel,
+    /// @brief Kirkpatrick-Seidel with the randomized bridge finder, O(n log h) on average
+    kirkpatrick_seidel_randomized,
+    /// @brief monotone chain for points the caller knows are sorted by x, O(n) (the order is not checked)
+    presorted,
+    /// @brief the unrolled kernels of tiny_hull.h for at most hull_tiny_limit points (more points go to jarvis)
+    tiny,
+    /// @brief Quickhull, O(n log n) on average and fast when few points are on the hull, O(n h) in the worst case
+    ///
+    /// compute_hull() runs it on the calling thread, the quick_hull class of quick_hull.h runs it on a thread pool
+    quickhull,
+};
+
+/// @brief below this many points the jarvis march is faster than Kirkpatrick-Seidel
+///
+/// the median of medians gives KS a large constant (see comparision.md), so for small sets the O(n h) march wins
+/// when every point is on the hull (the worst case for jarvis) they break even at about 32 points
+const int hull_jarvis_cutoff = 32;
+
+/// @brief the engine automatic stands for when there are n points
+///
+/// the tiny kernels beat the march up to their limit (1.3x at 4 points, 1.6x at 16)
+/// above hull_jarvis_cutoff automatic also looks at the order of the points and takes the O(n) path of sorted_hull.h when they
+/// are sorted by x or nearly (see hull_sorted_order())
+inline hull_engine hull_pick_engine(int n)
+{
+    if (n <= hull_tiny_limit)
+        return hull_engine::tiny;
+    return n <= hull_jarvis_cutoff ? hull_engine::jarvis : hull_engine::kirkpatrick_seidel;
+}
+
+/// @brief checks if pts is sorted by x, or nearly and then sorts its indices into ws.order
+/// @param order receives the order for sorted_hull(): nullptr if pts is sorted, ws.order if it was nearly sorted
+/// @return false if the input is not (nearly) sorted
+template <class P, class W>
+inline bool hull_sorted_order(const P *pts, int n, ks_workspace_of<W> &ws, const int *&order)
+{
+    order = nullptr;
+    switch (hull_presorted(pts, n))
+    {
+    case hull_input_order::sorted:
+        return true;
+    case hull_input_order::nearly_sorted:
+        /// a few points which moved far make it quadratic, give up after a few moves per point
+        if (!hull_insertion_sort(pts, n, ws.order, 4LL * n))
+            return false;
+        order = ws.order.data();
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// @brief computes the convex hull of pts[0..n) with the given engine
+///
+/// the hull starts at the leftmost point and goes along the upper hull first, collinear points are dropped
+/// int32 coordinates can take the whole int32 range, float and double ones any finite values as long as the products of two
+/// differences neither overflow nor underflow a double (magnitudes between about 1e-70 and 1e150), see hull_det_sign()
+/// @param pts the points (Vector2 or any point type of hull_point.h)
+/// @param out receives the hull, it needs room for n points
+/// @param ws scratch buffers, only touched by the engines which need them
+/// @return number of points in the hull
+template <class P>
+inline int compute_hull(hull_engine engine, const P *pts, int n, P *out, ks_workspace_of<P> &ws)
+{
+    const int *order = nullptr;
+    if (engine == hull_engine::automatic)
+    {
+        engine = hull_pick_engine(n);
+        if (engine == hull_engine::kirkpatrick_seidel && hull_sorted_order(pts, n, ws, order))
+            engine = hull_engine::presorted;
+    }
+    switch (engine)
+    {
+    case hull_engine::tiny:
+        if (n <= hull_tiny_limit)
+            return tiny_hull(pts, n, out);
+        return jarvis_hull(pts, n, out);
+    case hull_engine::jarvis:
+        return jarvis_hull(pts, n, out);
+    case hull_engine::presorted:
+        return sorted_hull(pts, n, order, out, ws.ids);
+    case hull_engine::quickhull:
+        return quick_hull_work(pts, n, out, ws.quick);
+    case hull_engine::kirkpatrick_seidel_randomized:
+        ws.finder = ks_bridge_finder::randomized;
+        return ks_hull(pts, n, out, ws);
+    default:
+        ws.finder = ks_bridge_finder::median_of_medians;
+        return ks_hull(pts, n, out, ws);
+    }
+}
+
+/// @brief computes the convex hull of the points with the given engine
+/// @return the points on the hull
+template <class P>
+inline std::vector<P> compute_hull(hull_engine engine, const std::vector<P> &points)
+{
+    ks_workspace_of<P> ws;
+    std::vector<P> out(points.size());
+    out.resize(compute_hull(engine, points.data(), (int)points.size(), out.data(), ws));
+    return out;
+}
+
+/// @brief computes the convex hull of pts[0..n) with the given engine and gives it as indices into pts
+///
+/// same hull and order as compute_hull(), so a hull point can be traced back to whatever the caller keeps next to it
+/// @param out receives the indices of the hull points, it needs room for n of them
+/// @param ws scratch buffers (of indexed points), only touched by the engines which need them
+/// @return number of points in the hull
+template <class P>
+inline int compute_hull_indices(hull_engine engine, const P *pts, int n, int *out, ks_index_workspace_of<P> &ws)
+{
+    const int *order = nullptr;
+    if (engine == hull_engine::automatic)
+    {
+        engine = hull_pick_engine(n);
+        if (engine == hull_engine::kirkpatrick_seidel && hull_sorted_order(pts, n, ws, order))
+            engine = hull_engine::presorted;
+    }
+    switch (engine)
+    {
+    case hull_engine::tiny:
+        if (n <= hull_tiny_limit)
+            return tiny_hull_indices(pts, n, out);
+        return jarvis_hull_indices(pts, n, out);
+    case hull_engine::jarvis:
+        return jarvis_hull_indices(pts, n, out);
+    case hull_engine::presorted:
+    {
+        int h = sorted_hull_ids(pts, n, order, ws.ids);
+        std::copy(ws.ids.begin(), ws.ids.begin() + h, out);
+        return h;
+    }
+    case hull_engine::quickhull:
+    {
+        ws.hull.resize(std::max(n, 0));
+        int h = quick_hull_work(pts, n, ws.hull.data(), ws.quick);
+        for (int i = 0; i < h; i++)
+            out[i] = ws.hull[i].id;
+        return h;
+    }
+    case hull_engine::kirkpatrick_seidel_randomized:
+        ws.finder = ks_bridge_finder::randomized;
+        return ks_hull_indices(pts, n, out, ws);
+    default:
+        ws.finder = ks_bridge_finder::median_of_medians;
+        return ks_hull_indices(pts, n, out, ws);
+    }
+}
+
+/// @brief computes the convex hull of the points with the given engine
+/// @return the indices of the points on the hull
+template <class P>
+inline std::vector<int> compute_hull_indices(hull_engine engine, const std::vector<P> &points)
+{
+    ks_index_workspace_of<P> ws;
+    std::vector<int> out(points.size());
+    out.resize(compute_hull_indices(engine, points.data(), (int)points.size(), out.data(), ws));
+    return out;
+}
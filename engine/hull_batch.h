@@ -0,0 +1,67 @@
+#pragma once
+
+/// @file hull_batch.h
+/// @brief computes the hulls of many independent point sets at once
+
+#include <vector>
+#include <cstddef>
+#include "hull.h"
+#include "thread_pool.h"
+
+/// @brief computes the hulls of many small point sets on a thread pool
+///
+/// the sets are given as one flat buffer of points plus offsets: set i is points[offsets[i] .. offsets[i+1])
+/// every worker has its own scratch buffers which are kept between calls, so after the first few sets no hull allocates anything
+template <class P = Vector2>
+class hull_batch
+{
+public:
+    /// @param threads number of threads, 0 means one per hardware thread
+    explicit hull_batch(unsigned threads = 0) : pool(threads), workspaces(pool.size()) {}
+
+    /// @brief the engine used for every set, automatic picks it per set from its size
+    hull_engine engine = hull_engine::automatic;
+
+    /// @brief number of sets a worker claims at a time
+    size_t grain = 64;
+
+    /// @brief computes the hull of every set
+    ///
+    /// hull i is written to out[offsets[i] ..] (a hull never has more points than its set, so out has the same size as points)
+    /// and its number of points to counts[i]
+    /// @param points all the points
+    /// @param offsets sets+1 offsets into points, offsets[0] is 0 and offsets[sets] is the total number of points
+    /// @param sets number of point sets
+    /// @param out receives the hulls, same size as points
+    /// @param counts receives the number of points in each hull
+    void run(const P *points, const size_t *offsets, size_t sets, P *out, int *counts)
+    {
+        pool.parallel_for(sets, grain, [&](unsigned worker, size_t begin, size_t end)
+                          {
+            ks_workspace_of<P> &ws = workspaces[worker];
+            for (size_t i = begin; i < end; i++)
+            {
+                size_t first = offsets[i];
+                int n = (int)(offsets[i + 1] - first);
+                counts[i] = compute_hull(engine, points + first, n, out + first, ws);
+            } });
+    }
+
+    /// @brief computes the hull of every set
+    /// @param out resized to points.size(), hull i starts at out[offsets[i]]
+    /// @param counts resized to the number of sets
+    void run(const std::vector<P> &points, const std::vector<size_t> &offsets, std::vector<P> &out, std::vector<int> &counts)
+    {
+        size_t sets = offsets.empty() ? 0 : offsets.size() - 1;
+        out.resize(points.size());
+        counts.resize(sets);
+        run(points.data(), offsets.data(), sets, out.data(), counts.data());
+    }
+
+    /// @brief number of threads working on the batch
+    unsigned threads() const { return pool.size(); }
+
+private:
+    hull_thread_pool pool;
+    std::vector<ks_workspace_of<P>> workspaces;
+};
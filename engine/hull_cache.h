@@ -0,0 +1,211 @@
+#pragma once
+
+/// @file hull_cache.h
+/// @brief cache of computed hulls keyed by a fingerprint of the point set
+///
+/// the fingerprint is a sum of hashes of the points, so it does not depend on the order of the points (the hull does not either)
+/// and it is one pass over the points with no dependency between them, much cheaper than any hull engine
+/// the cache keeps the most recently used hulls up to a memory limit
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "hull_point.h"
+
+/// @brief fingerprint of a point set: number of points and two independent sums of point hashes
+struct hull_fingerprint
+{
+    uint64_t n = 0;
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+    bool operator==(const hull_fingerprint &o) const { return n == o.n && sum1 == o.sum1 && sum2 == o.sum2; }
+};
+
+/// @brief hash of a fingerprint, to use it as the key of a hash table
+struct hull_fingerprint_hash
+{
+    size_t operator()(const hull_fingerprint &f) const { return (size_t)(f.sum1 ^ (f.sum2 * 0x9e3779b97f4a7c15ull) ^ f.n); }
+};
+
+/// @brief computes the fingerprint of a point set in one pass, the points can be given in chunks
+template <class P>
+class hull_hasher
+{
+public:
+    /// @brief adds n points to the fingerprint
+    void update(const P *pts, size_t n)
+    {
+        uint64_t s1 = 0, s2 = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t x = bits(pts[i].x), y = bits(pts[i].y);
+            /// two different mixes of the point, a collision needs both sums to collide
+            s1 += mix(x * 0x9e3779b97f4a7c15ull ^ y);
+            s2 += mix(y * 0xc2b2ae3d27d4eb4full ^ x ^ 0x165667b19e3779f9ull);
+        }
+        f.n += n;
+        f.sum1 += s1;
+        f.sum2 += s2;
+    }
+
+    /// @brief the fingerprint of all the points added so far
+    hull_fingerprint digest() const { return f; }
+
+private:
+    /// @brief the bits of a coordinate, 0.0 and -0.0 are the same point
+    template <class T>
+    static uint64_t bits(T v)
+    {
+        if (v == 0)
+            v = 0;
+        uint64_t b = 0;
+        std::memcpy(&b, &v, sizeof(T));
+        return b;
+    }
+
+    /// @brief finalizer of murmur3
+    static uint64_t mix(uint64_t z)
+    {
+        z ^= z >> 33;
+        z *= 0xff51afd7ed558ccdull;
+        z ^= z >> 33;
+        z *= 0xc4ceb9fe1a85ec53ull;
+        return z ^ (z >> 33);
+    }
+
+    hull_fingerprint f;
+};
+
+/// @brief fingerprint of pts[0..n)
+template <class P>
+inline hull_fingerprint hull_fingerprint_of(const P *pts, size_t n)
+{
+    hull_hasher<P> hasher;
+    hasher.update(pts, n);
+    return hasher.digest();
+}
+
+/// @brief least recently used cache of hulls, safe to use from several threads
+template <class P = Vector2>
+class hull_cache
+{
+public:
+    /// @param max_bytes memory the cached hulls may use (the hulls plus a fixed cost per entry)
+    /// @param max_entries maximum number of hulls, 0 means only the memory limit applies
+    explicit hull_cache(size_t max_bytes = 64 << 20, size_t max_entries = 0) : max_bytes(max_bytes), max_entries(max_entries) {}
+
+    /// @brief looks up a hull
+    /// @param hull receives the hull if it is in the cache
+    /// @return true if it was in the cache (it becomes the most recently used one)
+    bool find(const hull_fingerprint &key, std::vector<P> &hull)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+            miss_count++;
+            return false;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        hull = it->second->hull;
+        hit_count++;
+        return true;
+    }
+
+    /// @brief stores a hull, the least recently used hulls are dropped until it fits
+    void insert(const hull_fingerprint &key, const std::vector<P> &hull)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            used -= cost(it->second->hull);
+            entries.erase(it->second);
+            index.erase(it);
+        }
+        if (cost(hull) > max_bytes)
+            return;
+        entries.push_front(entry{key, hull});
+        index[key] = entries.begin();
+        used += cost(hull);
+        while (used > max_bytes || (max_entries && entries.size() > max_entries))
+        {
+            used -= cost(entries.back().hull);
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+    }
+
+    /// @brief the hull of pts[0..n) from the cache, or computed with compute(pts, n, hull) and stored
+    /// @param compute called as compute(const P *pts, size_t n, std::vector<P> &hull) on a miss
+    /// @return true if it was in the cache
+    template <class F>
+    bool get(const P *pts, size_t n, std::vector<P> &hull, F compute)
+    {
+        hull_fingerprint key = hull_fingerprint_of(pts, n);
+        if (find(key, hull))
+            return true;
+        compute(pts, n, hull);
+        insert(key, hull);
+        return false;
+    }
+
+    /// @brief drops every hull
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+        used = 0;
+    }
+
+    /// @brief number of cached hulls
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    /// @brief memory used by the cached hulls, as counted against max_bytes
+    size_t bytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return used;
+    }
+
+    /// @brief number of lookups which found their hull
+    size_t hits()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hit_count;
+    }
+
+    /// @brief number of lookups which did not find their hull
+    size_t misses()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return miss_count;
+    }
+
+private:
+    struct entry
+    {
+        hull_fingerprint key;
+        std::vector<P> hull;
+    };
+
+    /// @brief memory of one entry: the hull and about the size of the list node and of the hash table node
+    static size_t cost(const std::vector<P> &hull) { return hull.size() * sizeof(P) + sizeof(entry) + 64; }
+
+    size_t max_bytes;
+    size_t max_entries;
+    size_t used = 0;
+    size_t hit_count = 0, miss_count = 0;
+    std::list<entry> entries;
+    std::unordered_map<hull_fingerprint, typename std::list<entry>::iterator, hull_fingerprint_hash> index;
+    std::mutex mutex;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+/// @file hull_calipers.h
+/// @brief area, perimeter, diameter, width and minimum area bounding rectangle of a hull, with rotating calipers
+///
+/// the calipers walk the edges of the hull once: for every edge the point farthest from its line and the two points with the
+/// smallest and the largest projection on it only move forward, so all the measures together take O(h) instead of the
+/// O(n^2) pairs of points (diameter) or the O(n) scan per direction (width, rectangle) of doing it on the points
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "hull_point.h"
+#include "thread_pool.h"
+
+/// @brief measures of a convex polygon, computed in double whatever the point type
+struct hull_measures
+{
+    double area = 0;
+    double perimeter = 0;
+    /// @brief largest distance between two points of the hull, and the indices of those points
+    double diameter = 0;
+    int diameter_a = -1, diameter_b = -1;
+    /// @brief smallest distance between two parallel lines enclosing the hull, one of them is the line of edge width_edge -> width_edge+1
+    double width = 0;
+    int width_edge = -1;
+    /// @brief smallest rectangle enclosing the hull (one of its sides is on an edge of the hull), corners in order around it
+    double rect_area = 0;
+    hull_point_f64 rect[4] = {};
+};
+
+/// @brief measures a hull with rotating calipers
+/// @param hull the points of a convex polygon in order around it, without collinear points (the engine order is fine)
+template <class P>
+inline hull_measures measure_hull(const P *hull, int n)
+{
+    hull_measures m;
+    if (n == 0)
+        return m;
+    auto pt = [&](int i)
+    {
+        const P &p = hull[i % n];
+        return hull_point_f64{(double)p.x, (double)p.y};
+    };
+    if (n < 3)
+    {
+        hull_point_f64 a = pt(0), b = pt(n - 1);
+        m.diameter = std::hypot(b.x - a.x, b.y - a.y);
+        m.diameter_a = 0;
+        m.diameter_b = n - 1;
+        m.perimeter = 2 * m.diameter;
+        m.width_edge = 0;
+        m.rect[0] = a;
+        m.rect[1] = b;
+        m.rect[2] = b;
+        m.rect[3] = a;
+        return m;
+    }
+
+    /// twice the signed area, its sign tells on which side of the edges the inside is
+    double twice_area = 0;
+    for (int i = 0; i < n; i++)
+    {
+        hull_point_f64 a = pt(i), b = pt(i + 1);
+        twice_area += a.x * b.y - a.y * b.x;
+    }
+    double s = twice_area > 0 ? 1 : -1;
+    m.area = std::fabs(twice_area) / 2;
+    m.width = INFINITY;
+    m.rect_area = INFINITY;
+
+    /// far: farthest point from the edge line, front / back: largest / smallest projection on the edge direction
+    /// going around from the edge they come in the order front, far, back, so each one starts where the previous one is
+    int far = 1, front = 1, back = 1;
+    for (int i = 0; i < n; i++)
+    {
+        hull_point_f64 a = pt(i), b = pt(i + 1);
+        double len = std::hypot(b.x - a.x, b.y - a.y);
+        m.perimeter += len;
+        double ux = (b.x - a.x) / len, uy = (b.y - a.y) / len;
+        /// unit normal pointing to the inside
+        double nx = -uy * s, ny = ux * s;
+        auto along = [&](int k)
+        {
+            hull_point_f64 p = pt(k);
+            return (p.x - a.x) * ux + (p.y - a.y) * uy;
+        };
+        auto height = [&](int k)
+        {
+            hull_point_f64 p = pt(k);
+            return (p.x - a.x) * nx + (p.y - a.y) * ny;
+        };
+        if (front < i + 1)
+            front = i + 1;
+        while (front < i + n && along(front + 1) > along(front))
+            front++;
+        if (far < front)
+            far = front;
+        while (far < i + n && height(far + 1) > height(far))
+            far++;
+        if (back < far)
+            back = far;
+        while (back < i + n && along(back + 1) < along(back))
+            back++;
+
+        /// every antipodal pair shows up as (an end of the edge, the farthest point), a parallel edge gives two farthest points
+        double h = height(far);
+        int candidates[4][2] = {{i, far}, {i + 1, far}, {i, far + 1}, {i + 1, far + 1}};
+        int count = height(far + 1) == h ? 4 : 2;
+        for (int c = 0; c < count; c++)
+        {
+            hull_point_f64 p = pt(candidates[c][0]), q = pt(candidates[c][1]);
+            double d = std::hypot(q.x - p.x, q.y - p.y);
+            if (d > m.diameter)
+            {
+                m.diameter = d;
+                m.diameter_a = candidates[c][0] % n;
+                m.diameter_b = candidates[c][1] % n;
+            }
+        }
+        if (h < m.width)
+        {
+            m.width = h;
+            m.width_edge = i;
+        }
+        double lo = along(back), hi = along(front);
+        if ((hi - lo) * h < m.rect_area)
+        {
+            m.rect_area = (hi - lo) * h;
+            m.rect[0] = {a.x + ux * lo, a.y + uy * lo};
+            m.rect[1] = {a.x + ux * hi, a.y + uy * hi};
+            m.rect[2] = {m.rect[1].x + nx * h, m.rect[1].y + ny * h};
+            m.rect[3] = {m.rect[0].x + nx * h, m.rect[0].y + ny * h};
+        }
+    }
+    return m;
+}
+
+/// @brief measures a hull with rotating calipers
+template <class P>
+inline hull_measures measure_hull(const std::vector<P> &hull) { return measure_hull(hull.data(), (int)hull.size()); }
+
+/// @brief measures many hulls, laid out like the output of hull_batch: hull i is hulls[offsets[i] ..] with counts[i] points
+/// @param out receives the measures of every hull
+/// @param pool spreads the hulls over its workers, nullptr measures them on the calling thread
+template <class P>
+inline void measure_hulls(const P *hulls, const size_t *offsets, const int *counts, size_t sets, hull_measures *out, hull_thread_pool *pool = nullptr)
+{
+    auto run = [&](unsigned, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            out[i] = measure_hull(hulls + offsets[i], counts[i]);
+    };
+    if (pool)
+        pool->parallel_for(sets, 256, run);
+    else
+        run(0u, (size_t)0, sets);
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+/// @file hull_merge.h
+/// @brief merges two hulls which are already computed, when one is entirely to the left of the other
+///
+/// the upper and the lower bridge (the common tangents) are found with binary searches on the hulls, the merged hull is the left
+/// hull up to the bridges and the right hull after them, so only the copy of the result is linear
+/// hulls which overlap are merged by hull_union() in linear time: their chains are already sorted by x
+
+#include <algorithm>
+#include <vector>
+#include "hull_point.h"
+#include "sorted_hull.h"
+
+/// @brief the upper or the lower hull of a hull in the engine order, seen as a chain from left to right
+///
+/// the hull is not copied: the upper hull is hull[0..right_top], the lower hull is hull[right_bottom..n-1] read backwards
+/// (and hull[0] at its left end when the hull has no vertical edge there)
+template <class P>
+struct hull_chain
+{
+    const P *hull = nullptr;
+    int n = 0;
+    bool lower = false;
+    /// @brief index of the rightmost point of the upper hull
+    int right_top = 0;
+    /// @brief index of the rightmost point of the lower hull
+    int right_bottom = 0;
+    /// @brief true if the lower hull starts at hull[0] (no vertical edge on the left)
+    bool shared_left = false;
+
+    hull_chain(const P *h, int count, bool lower_chain) : hull(h), n(count), lower(lower_chain)
+    {
+        for (int i = 1; i < n; i++)
+        {
+            if (hull[i].x > hull[right_top].x)
+                right_top = i;
+        }
+        /// the upper hull reaches the right end at its top point, a vertical edge on the right is the next point of the hull
+        right_bottom = right_top + 1 < n && hull[right_top + 1].x == hull[right_top].x ? right_top + 1 : right_top;
+        shared_left = hull[n - 1].x != hull[0].x;
+    }
+
+    /// @brief number of points of the chain
+    int size() const
+    {
+        if (!lower)
+            return right_top + 1;
+        return n - right_bottom + (shared_left ? 1 : 0);
+    }
+
+    /// @brief k-th point of the chain from the left
+    P operator[](int k) const
+    {
+        if (!lower)
+            return hull[k];
+        if (shared_left)
+            return k == 0 ? hull[0] : hull[n - k];
+        return hull[n - 1 - k];
+    }
+};
+
+/// @brief finds the upper (or lower) bridge between two chains, all the points of a must be to the left of all the points of b
+///
+/// for a point p of a the tangent to b is a binary search (the points of b before it are above the line p->b[j]), and the point of
+/// a which is on the bridge is a binary search over those tangents, so it takes O(log^2 h) orientation tests
+/// when several points are on the bridge the outer ones are picked, so the collinear points are dropped like in ks_hull()
+/// @param ia receives the index of the bridge in a
+/// @param ib receives the index of the bridge in b
+template <class P>
+inline void hull_bridge(const hull_chain<P> &a, const hull_chain<P> &b, int &ia, int &ib)
+{
+    int above = b.lower ? 2 : 1;
+    int below = b.lower ? 1 : 2;
+    /// last point of b on the tangent from p
+    auto tangent = [&](const P &p)
+    {
+        int lo = 0, hi = b.size() - 1;
+        while (lo < hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (hull_orientation(p, b[mid], b[mid + 1]) != below)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    };
+    /// first point of a with its next point not above its tangent to b
+    int lo = 0, hi = a.size() - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        P p = a[mid];
+        if (hull_orientation(p, b[tangent(p)], a[mid + 1]) == above)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    ia = lo;
+    ib = tangent(a[lo]);
+}
+
+/// @brief merges the hulls a and b (in the engine order), every point of a must have a smaller x than every point of b
+/// @param out receives the hull in the engine order, it needs room for na+nb points and must not overlap a or b
+/// @return number of points in the merged hull
+template <class P>
+inline int hull_merge(const P *a, int na, const P *b, int nb, P *out)
+{
+    if (na == 0 || nb == 0)
+    {
+        const P *src = na == 0 ? b : a;
+        int n = na == 0 ? nb : na;
+        for (int i = 0; i < n; i++)
+            out[i] = src[i];
+        return n;
+    }
+    hull_chain<P> a_upper(a, na, false), b_upper(b, nb, false);
+    hull_chain<P> a_lower(a, na, true), b_lower(b, nb, true);
+    int ua, ub, la, lb;
+    hull_bridge(a_upper, b_upper, ua, ub);
+    hull_bridge(a_lower, b_lower, la, lb);
+
+    /// upper hull from left to right
+    int h = 0;
+    for (int k = 0; k <= ua; k++)
+        out[h++] = a_upper[k];
+    for (int k = ub; k < b_upper.size(); k++)
+        out[h++] = b_upper[k];
+    /// lower hull from right to left, without the ends it shares with the upper hull
+    int upper_end = h;
+    for (int k = b_lower.size() - 1; k >= lb; k--)
+    {
+        P p = b_lower[k];
+        if (h == upper_end && p.x == out[h - 1].x && p.y == out[h - 1].y)
+            continue;
+        out[h++] = p;
+    }
+    for (int k = la; k >= 0; k--)
+    {
+        P p = a_lower[k];
+        if (k == 0 && p.x == out[0].x && p.y == out[0].y)
+            break;
+        out[h++] = p;
+    }
+    return h;
+}
+
+/// @brief scratch buffers of hull_union()
+template <class P>
+struct hull_union_workspace
+{
+    std::vector<P> upper, lower, a, b, sorted;
+    std::vector<int> ids;
+};
+
+/// @brief merges the hulls a and b (in the engine order), which can overlap, in O(na + nb)
+///
+/// the two chains of a hull are sorted by x, so merging the four chains gives all the points sorted by x and the monotone chain
+/// of sorted_hull.h runs on them without a sort; same hull and order as ks_hull() on the points of both hulls
+/// @param out receives the hull in the engine order, it needs room for na+nb points (it may be a or b)
+/// @return number of points in the merged hull
+template <class P>
+inline int hull_union(const P *a, int na, const P *b, int nb, P *out, hull_union_workspace<P> &ws)
+{
+    auto by_x = [](const P &p, const P &q)
+    { return p.x < q.x; };
+    /// the points of a hull sorted by x, the two ends are in both chains, which the monotone chain does not mind
+    auto sorted_points = [&](const P *h, int n, std::vector<P> &to)
+    {
+        ws.upper.clear();
+        ws.lower.clear();
+        if (n > 0)
+        {
+            hull_chain<P> up(h, n, false), down(h, n, true);
+            for (int k = 0; k < up.size(); k++)
+                ws.upper.push_back(up[k]);
+            for (int k = 0; k < down.size(); k++)
+                ws.lower.push_back(down[k]);
+        }
+        to.resize(ws.upper.size() + ws.lower.size());
+        std::merge(ws.upper.begin(), ws.upper.end(), ws.lower.begin(), ws.lower.end(), to.begin(), by_x);
+    };
+    sorted_points(a, na, ws.a);
+    sorted_points(b, nb, ws.b);
+    ws.sorted.resize(ws.a.size() + ws.b.size());
+    std::merge(ws.a.begin(), ws.a.end(), ws.b.begin(), ws.b.end(), ws.sorted.begin(), by_x);
+    int m = (int)ws.sorted.size();
+    ws.ids.resize(2 * (size_t)m);
+    int h = sorted_hull_ids(ws.sorted.data(), m, [](int k)
+                            { return k; }, ws.ids.data());
+    for (int i = 0; i < h; i++)
+        out[i] = ws.sorted[ws.ids[i]];
+    return h;
+}
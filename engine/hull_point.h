@@ -0,0 +1,234 @@
+#pragma once
+
+/// @file hull_point.h
+/// @brief the point types and the predicates shared by all the hull engines
+///
+/// the engines do not depend on raylib, so they can be used by the command line tools as well as the visualizers
+/// when raylib.h is included first its Vector2 is used, so include raylib.h before the engine headers in the visualizers
+///
+/// the engines are templates on the point type: any struct with members x and y of type int32_t, float or double works
+/// (Vector2 is the float one), hull_coord_traits says how the predicates are evaluated for each coordinate type
+/// the predicates are exact for every coordinate type (as long as nothing overflows or underflows a double), see hull_det_sign()
+
+#include <cmath>
+#include <cstdint>
+
+#if !defined(RL_VECTOR2_TYPE) && !defined(RAYLIB_H)
+/// @brief a point in screen coordinates (same layout as the raylib Vector2)
+typedef struct Vector2
+{
+    float x;
+    float y;
+} Vector2;
+#define RL_VECTOR2_TYPE
+#endif
+
+/// @brief a point with coordinates of type T, for inputs which are not floats
+template <class T>
+struct hull_point
+{
+    T x;
+    T y;
+};
+
+/// @brief integer grid points, half the size of a double point and with exact predicates
+typedef hull_point<int32_t> hull_point_i32;
+/// @brief double precision points
+typedef hull_point<double> hull_point_f64;
+
+/// @brief a point of the caller's input together with its index in it
+///
+/// the engines run on these when the hull is asked for as indices (ks_hull_indices(), compute_hull_indices()), the index rides
+/// along with the coordinates through the partitions so the hull comes out as positions in the caller's array
+template <class T>
+struct hull_indexed_point
+{
+    T x;
+    T y;
+    int32_t id;
+};
+
+/// @brief how the predicates are evaluated for a coordinate type
+///
+/// wide is the type the coordinates and their differences are taken to, exact says if the wide type also holds the cross
+/// products without rounding; when it does not, hull_det_sign() rounds first and only redoes the close calls exactly
+template <class T>
+struct hull_coord_traits;
+
+/// @brief floats: a float is a double, but the difference of two floats of different magnitude can need more than the 53 bits
+/// of a double, and the product of two differences of floats of the same magnitude already needs about 50, so they are rounded
+template <>
+struct hull_coord_traits<float>
+{
+    typedef double wide;
+    static const bool exact = false;
+};
+
+template <>
+struct hull_coord_traits<double>
+{
+    typedef double wide;
+    static const bool exact = false;
+};
+
+/// @brief 32 bit integers, the whole int32 range: the differences fit in 64 bits, the products of two differences need up to 65
+/// bits so hull_det_sign() takes them in 128 bits (or in double with the exact fallback where the compiler has no 128 bit type)
+template <>
+struct hull_coord_traits<int32_t>
+{
+    typedef int64_t wide;
+    static const bool exact = true;
+};
+
+/// @brief coordinate type of a point type
+template <class P>
+struct hull_point_traits
+{
+    typedef decltype(P::x) coord;
+    typedef typename hull_coord_traits<coord>::wide wide;
+    static const bool exact = hull_coord_traits<coord>::exact;
+};
+
+/// @brief the indexed point type for the points of type P
+template <class P>
+using hull_indexed_of = hull_indexed_point<typename hull_point_traits<P>::coord>;
+
+/// @brief relative error bound of (a - b) * (c - d) - (e - f) * (g - h) evaluated in double: the rounded value is off by less
+/// than hull_det_error * (|(a - b) * (c - d)| + |(e - f) * (g - h)|) (Shewchuk's bound for the 2d orientation, (3 + 16 eps) eps)
+const double hull_det_error = (3.0 + 16.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16;
+
+/// @brief s + e == a + b exactly, s is the rounded sum
+inline void hull_two_sum(double a, double b, double &s, double &e)
+{
+    s = a + b;
+    double bv = s - a;
+    double av = s - bv;
+    e = (a - av) + (b - bv);
+}
+
+/// @brief the high and low 26 bits of a (Dekker's split)
+inline void hull_split(double a, double &hi, double &lo)
+{
+    double c = 134217729.0 * a;
+    hi = c - (c - a);
+    lo = a - hi;
+}
+
+/// @brief p + e == a * b exactly, p is the rounded product
+inline void hull_two_product(double a, double b, double &p, double &e)
+{
+    p = a * b;
+    double ah, al, bh, bl;
+    hull_split(a, ah, al);
+    hull_split(b, bh, bl);
+    e = al * bl - (((p - ah * bh) - al * bh) - ah * bl);
+}
+
+/// @brief sign of (a - b) * (c - d) - (e - f) * (g - h) with the differences and products kept exactly
+///
+/// every difference is a rounded difference and its error, so each product is 4 exact products of 2 terms: 16 terms, summed into
+/// a nonoverlapping expansion one at a time (Shewchuk's grow-expansion), the sign of the sum is the sign of its largest term
+inline int hull_det_sign_exact(double a, double b, double c, double d, double e, double f, double g, double h)
+{
+    double pairs[4][2] = {{a, b}, {c, d}, {e, f}, {g, h}}, diff[4][2];
+    for (int i = 0; i < 4; i++)
+        hull_two_sum(pairs[i][0], -pairs[i][1], diff[i][0], diff[i][1]);
+    double terms[16];
+    int n = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            hull_two_product(diff[0][i], diff[1][j], terms[n], terms[n + 1]);
+            hull_two_product(-diff[2][i], diff[3][j], terms[n + 2], terms[n + 3]);
+            n += 4;
+        }
+    }
+    double sum[16];
+    int m = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        double q = terms[i];
+        int k = 0;
+        for (int j = 0; j < m; j++)
+        {
+            double s, err;
+            hull_two_sum(q, sum[j], s, err);
+            if (err != 0)
+                sum[k++] = err;
+            q = s;
+        }
+        if (q != 0)
+            sum[k++] = q;
+        m = k;
+    }
+    if (m == 0)
+        return 0;
+    return sum[m - 1] > 0 ? 1 : -1;
+}
+
+/// @brief sign of (a - b) * (c - d) - (e - f) * (g - h), exact
+///
+/// every predicate of the engines is one of these (the orientation, the comparison of two slopes, of two lines of a slope, of
+/// the distances of two points to a line); it is evaluated in double and when the result is closer to 0 than the rounding can
+/// be off, which almost never happens, again with exact arithmetic
+/// @return 1, 0 or -1
+inline int hull_det_sign(double a, double b, double c, double d, double e, double f, double g, double h)
+{
+    double l = (a - b) * (c - d), r = (e - f) * (g - h), det = l - r;
+    double bound = hull_det_error * (std::fabs(l) + std::fabs(r));
+    if (det > bound)
+        return 1;
+    if (det < -bound)
+        return -1;
+    if (bound == 0)
+        return 0;
+    return hull_det_sign_exact(a, b, c, d, e, f, g, h);
+}
+
+/// @brief sign of (a - b) * (c - d) - (e - f) * (g - h) for the wide type of int32 coordinates
+///
+/// the arguments are int32 values (or their negation), so the differences fit in 64 bits but not their products
+/// @return 1, 0 or -1
+inline int hull_det_sign(int64_t a, int64_t b, int64_t c, int64_t d, int64_t e, int64_t f, int64_t g, int64_t h)
+{
+#if defined(__SIZEOF_INT128__)
+    __int128 val = (__int128)(a - b) * (c - d) - (__int128)(e - f) * (g - h);
+    return val > 0 ? 1 : (val < 0 ? -1 : 0);
+#else
+    /// the values are below 2^32, so they are exact in double
+    return hull_det_sign((double)a, (double)b, (double)c, (double)d, (double)e, (double)f, (double)g, (double)h);
+#endif
+}
+
+/// @brief crossproduct to let us know if point is on right /left or collinear
+///
+/// this is the same predicate as Upper_hull::orientation() in the visualizer, but exact (hull_det_sign()): nearly collinear
+/// points are never rounded to collinear, or to the wrong side
+/// in screen coordinates (origin at the top left) 1 means r is above the line p->q when going from left to right
+/// @return if its 0 then colinear ,if 1 then counterclockwise (r is above), if 2 then clockwise (r is below)
+template <class P>
+inline int hull_orientation(const P &p, const P &q, const P &r)
+{
+    typedef typename hull_point_traits<P>::wide wide;
+    int sign = hull_det_sign((wide)q.y, (wide)p.y, (wide)r.x, (wide)q.x, (wide)q.x, (wide)p.x, (wide)r.y, (wide)q.y);
+    if (sign == 0)
+        return 0;
+    return (sign > 0) ? 1 : 2;
+}
+
+/// @brief says if b is farther from o than a, for three collinear points (the jarvis march keeps the farther one on a tie)
+///
+/// on a line the distances compare like the distances along x (along y if the line is vertical), |b.x - o.x| > |a.x - o.x| is
+/// one more hull_det_sign() with the signs as factors, so nothing is squared and nothing rounds or overflows
+template <class P>
+inline bool hull_farther(const P &o, const P &a, const P &b)
+{
+    typedef typename hull_point_traits<P>::wide wide;
+    bool vertical = a.x == o.x && b.x == o.x;
+    wide oc = vertical ? (wide)o.y : (wide)o.x;
+    wide ac = vertical ? (wide)a.y : (wide)a.x;
+    wide bc = vertical ? (wide)b.y : (wide)b.x;
+    wide sa = ac < oc ? -1 : 1, sb = bc < oc ? -1 : 1;
+    return hull_det_sign(bc, oc, sb, (wide)0, ac, oc, sa, (wide)0) > 0;
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+/// @file hull_query.h
+/// @brief point in hull and extreme point queries on a hull which is already computed
+///
+/// the hull (in the engine order) is split into its upper and lower chains, which are sorted by x, so a point is located with one
+/// binary search on each chain and the extreme point in a direction with one binary search on one chain: O(log h) per query
+/// arrays of queries can be spread over a thread pool, and for small hulls the points are tested against every edge at once with
+/// the vector instructions of hull_simd.h, which beats the two binary searches up to about 16 points
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "hull_point.h"
+#include "hull_merge.h"
+#include "hull_simd.h"
+#include "thread_pool.h"
+
+/// @brief where a query point is with respect to the hull
+enum hull_location
+{
+    hull_outside = 0,
+    hull_on_boundary = 1,
+    hull_inside = 2
+};
+
+/// @brief answers point location and extreme point queries on a convex hull
+///
+/// the hull is copied, so the query does not depend on the buffer it was built from
+template <class P = Vector2>
+class hull_query
+{
+public:
+    typedef typename hull_point_traits<P>::wide wide;
+
+    /// @brief a hull with at most this many points is located with the vector scan over all its edges instead of binary searches
+    static const int scan_limit = 16;
+
+    /// @brief number of queries a worker claims at a time in the batched calls
+    size_t grain = 1 << 14;
+
+    hull_query() {}
+
+    /// @param hull the hull in the engine order (as returned by compute_hull() or ks_hull())
+    hull_query(const P *hull, int n) { build(hull, n); }
+    explicit hull_query(const std::vector<P> &hull) { build(hull.data(), (int)hull.size()); }
+
+    /// @brief builds the query structure over a hull in the engine order
+    void build(const P *hull, int n)
+    {
+        pts.assign(hull, hull + n);
+        upper.clear();
+        lower.clear();
+        ea.clear();
+        eb.clear();
+        ex.clear();
+        ey.clear();
+        if (n == 0)
+            return;
+        hull_chain<P> up(pts.data(), n, false), down(pts.data(), n, true);
+        for (int i = 0; i < up.size(); i++)
+            upper.push_back(i);
+        /// hull_chain gives the lower points, their indices are found the same way it finds them
+        for (int k = 0; k < down.size(); k++)
+            lower.push_back(!down.shared_left ? n - 1 - k : (k == 0 ? 0 : n - k));
+        upper_pts.clear();
+        lower_pts.clear();
+        for (int i : upper)
+            upper_pts.push_back(pts[i]);
+        for (int i : lower)
+            lower_pts.push_back(pts[i]);
+        xmin = pts[0].x;
+        xmax = pts[up.right_top].x;
+        if (n >= 3 && !hull_point_traits<P>::exact)
+        {
+            /// the edges as the vector scan uses them: hull_orientation(l, r, p) is a*(p.x-r.x) - b*(p.y-r.y)
+            for (int i = 0; i < n; i++)
+            {
+                const P &l = pts[i], &r = pts[(i + 1) % n];
+                ea.push_back((double)r.y - l.y);
+                eb.push_back((double)r.x - l.x);
+                ex.push_back((double)r.x);
+                ey.push_back((double)r.y);
+            }
+        }
+    }
+
+    /// @brief number of points of the hull
+    int size() const { return (int)pts.size(); }
+
+    /// @brief the hull the queries are answered on
+    const std::vector<P> &hull() const { return pts; }
+
+    /// @brief where p is with respect to the hull
+    /// @return hull_outside, hull_on_boundary or hull_inside
+    int locate(const P &p) const
+    {
+        if (pts.empty() || p.x < xmin || p.x > xmax)
+            return hull_outside;
+        if (xmin == xmax)
+        {
+            /// a single point or a vertical segment, the lower chain ends at its bottom point
+            const P &top = pts[0], &bottom = pts[lower.back()];
+            return p.y >= top.y && p.y <= bottom.y ? hull_on_boundary : hull_outside;
+        }
+        /// the edges are tested in the hull direction, so the inside is orientation 2 on both of them
+        int i = segment(upper_pts, p);
+        int o1 = hull_orientation(upper_pts[i], upper_pts[i + 1], p);
+        if (o1 == 1)
+            return hull_outside;
+        int j = segment(lower_pts, p);
+        int o2 = hull_orientation(lower_pts[j + 1], lower_pts[j], p);
+        if (o2 == 1)
+            return hull_outside;
+        if (o1 == 0 || o2 == 0 || p.x == xmin || p.x == xmax)
+            return hull_on_boundary;
+        return hull_inside;
+    }
+
+    /// @brief true if p is inside the hull or on its boundary
+    bool contains(const P &p) const { return locate(p) != hull_outside; }
+
+    /// @brief index in hull() of a point which maximizes d.x*p.x + d.y*p.y
+    ///
+    /// when an edge is perpendicular to d either of its ends can be returned
+    /// @return the index, or -1 if the hull is empty
+    int extreme(const P &d) const
+    {
+        if (pts.empty())
+            return -1;
+        /// in screen coordinates the upper chain has the smaller y, so it holds the extreme points of the directions with d.y < 0
+        if (d.y == 0)
+            return d.x > 0 ? upper.back() : 0;
+        const std::vector<int> &chain = d.y < 0 ? upper : lower;
+        const std::vector<P> &chain_pts = d.y < 0 ? upper_pts : lower_pts;
+        /// along a chain d.(next - current) only decreases, the extreme point is the first one where it stops being positive
+        int lo = 0, hi = (int)chain.size() - 1;
+        while (lo < hi)
+        {
+            int mid = (lo + hi) / 2;
+            const P &a = chain_pts[mid], &b = chain_pts[mid + 1];
+            /// the sign of d.x*(b.x - a.x) + d.y*(b.y - a.y)
+            if (hull_det_sign((wide)d.x, (wide)0, (wide)b.x, (wide)a.x, (wide)0, (wide)d.y, (wide)b.y, (wide)a.y) > 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return chain[lo];
+    }
+
+    /// @brief locates n points, out[i] receives locate(queries[i])
+    /// @param pool spreads the queries over its workers, nullptr runs them on the calling thread
+    void locate(const P *queries, size_t n, uint8_t *out, hull_thread_pool *pool = nullptr) const
+    {
+        auto run = [&](unsigned, size_t begin, size_t end)
+        {
+            if (!ea.empty() && size() <= scan_limit)
+                scan(queries + begin, end - begin, out + begin);
+            else
+            {
+                for (size_t i = begin; i < end; i++)
+                    out[i] = (uint8_t)locate(queries[i]);
+            }
+        };
+        if (pool)
+            pool->parallel_for(n, grain, run);
+        else
+            run(0u, (size_t)0, n);
+    }
+
+    /// @brief extreme points of n directions, out[i] receives extreme(directions[i])
+    /// @param pool spreads the queries over its workers, nullptr runs them on the calling thread
+    void extreme(const P *directions, size_t n, int *out, hull_thread_pool *pool = nullptr) const
+    {
+        auto run = [&](unsigned, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+                out[i] = extreme(directions[i]);
+        };
+        if (pool)
+            pool->parallel_for(n, grain, run);
+        else
+            run(0u, (size_t)0, n);
+    }
+
+private:
+    /// @brief index i of the edge chain[i] -> chain[i+1] which spans p.x (p.x must be inside the chain)
+    ///
+    /// the last point of the chain with x <= p.x, without its last point; the search has no branch to mispredict
+    static int segment(const std::vector<P> &chain, const P &p)
+    {
+        const P *base = chain.data();
+        int n = (int)chain.size() - 1;
+        while (n > 1)
+        {
+            int half = n / 2;
+            base = base[half].x <= p.x ? base + half : base;
+            n -= half;
+        }
+        return (int)(base - chain.data());
+    }
+
+    /// @brief locates the points by testing them against every edge of the hull (at least 3 points, not exact coordinates)
+    ///
+    /// a point is outside if it is above one edge, on the boundary if it is on the line of an edge and above none, else inside
+    /// the crossproducts are the ones of hull_orientation() in double, a point which is above no edge but within the error bound
+    /// (hull_det_error) of the line of one is located again with locate(), so the answers are the same
+    void scan(const P *queries, size_t n, uint8_t *out) const
+    {
+        size_t i = 0;
+        int h = size();
+#if defined(HULL_SIMD_SSE2) || defined(HULL_SIMD_WASM)
+        for (; i + 2 <= n; i += 2)
+        {
+#if defined(HULL_SIMD_SSE2)
+            __m128d px = _mm_set_pd((double)queries[i + 1].x, (double)queries[i].x);
+            __m128d py = _mm_set_pd((double)queries[i + 1].y, (double)queries[i].y);
+            __m128d zero = _mm_setzero_pd(), above = zero, unsure = zero;
+            __m128d verror = _mm_set1_pd(hull_det_error), sign = _mm_set1_pd(-0.0);
+            for (int e = 0; e < h; e++)
+            {
+                __m128d t1 = _mm_mul_pd(_mm_set1_pd(ea[e]), _mm_sub_pd(px, _mm_set1_pd(ex[e])));
+                __m128d t2 = _mm_mul_pd(_mm_set1_pd(eb[e]), _mm_sub_pd(py, _mm_set1_pd(ey[e])));
+                __m128d val = _mm_sub_pd(t1, t2);
+                __m128d bound = _mm_mul_pd(verror, _mm_add_pd(_mm_andnot_pd(sign, t1), _mm_andnot_pd(sign, t2)));
+                above = _mm_or_pd(above, _mm_cmpgt_pd(val, bound));
+                unsure = _mm_or_pd(unsure, _mm_cmple_pd(_mm_andnot_pd(sign, val), bound));
+            }
+            int out_mask = _mm_movemask_pd(above), unsure_mask = _mm_movemask_pd(unsure);
+#else
+            v128_t px = wasm_f64x2_make((double)queries[i].x, (double)queries[i + 1].x);
+            v128_t py = wasm_f64x2_make((double)queries[i].y, (double)queries[i + 1].y);
+            v128_t zero = wasm_f64x2_splat(0.0), above = zero, unsure = zero;
+            v128_t verror = wasm_f64x2_splat(hull_det_error);
+            for (int e = 0; e < h; e++)
+            {
+                v128_t t1 = wasm_f64x2_mul(wasm_f64x2_splat(ea[e]), wasm_f64x2_sub(px, wasm_f64x2_splat(ex[e])));
+                v128_t t2 = wasm_f64x2_mul(wasm_f64x2_splat(eb[e]), wasm_f64x2_sub(py, wasm_f64x2_splat(ey[e])));
+                v128_t val = wasm_f64x2_sub(t1, t2);
+                v128_t bound = wasm_f64x2_mul(verror, wasm_f64x2_add(wasm_f64x2_abs(t1), wasm_f64x2_abs(t2)));
+                above = wasm_v128_or(above, wasm_f64x2_gt(val, bound));
+                unsure = wasm_v128_or(unsure, wasm_f64x2_le(wasm_f64x2_abs(val), bound));
+            }
+            int out_mask = (int)wasm_i64x2_bitmask(above), unsure_mask = (int)wasm_i64x2_bitmask(unsure);
+#endif
+            for (int k = 0; k < 2; k++)
+            {
+                /// a point on the line of an edge is always unsure, so the boundary points all go through locate()
+                if (out_mask & (1 << k))
+                    out[i + k] = hull_outside;
+                else
+                    out[i + k] = unsure_mask & (1 << k) ? (uint8_t)locate(queries[i + k]) : (uint8_t)hull_inside;
+            }
+        }
+#endif
+        for (; i < n; i++)
+            out[i] = (uint8_t)locate(queries[i]);
+    }
+
+    std::vector<P> pts;
+    /// @brief indices in pts of the upper and the lower chain, from left to right
+    std::vector<int> upper, lower;
+    /// @brief the points of the chains, so the searches do not go through the indices
+    std::vector<P> upper_pts, lower_pts;
+    typename hull_point_traits<P>::coord xmin = 0, xmax = 0;
+    /// @brief the edges for the vector scan, empty when the scan is not used
+    std::vector<double> ea, eb, ex, ey;
+};
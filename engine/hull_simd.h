@@ -0,0 +1,224 @@
+#pragma once
+
+/// @file hull_simd.h
+/// @brief vectorized versions of the O(n) scans the engines do over all the points
+///
+/// there is a path for SSE2 (every x86-64 build), one for wasm simd128 (emscripten with -msimd128) and a plain loop for the rest
+/// the vector paths evaluate the crossproduct of hull_orientation() in double together with its error bound (hull_det_error),
+/// and the points too close to the line to tell are tested again with hull_orientation(), so all paths keep exactly the same
+/// points
+
+#include "hull_point.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define HULL_SIMD_WASM 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HULL_SIMD_SSE2 1
+#endif
+
+/// @brief name of the vector path compiled in, printed by the benchmarks
+inline const char *hull_simd_name()
+{
+#if defined(HULL_SIMD_WASM)
+    return "wasm-simd128";
+#elif defined(HULL_SIMD_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+/// @brief copies the points with hull_orientation(l, r, p) == side to out (plain loop for the point types without a vector path)
+template <class P>
+inline int hull_select_side(const P *pts, int n, P l, P r, int side, bool keep_collinear, P *out)
+{
+    int w = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int o = hull_orientation(l, r, pts[i]);
+        if (o == side || (keep_collinear && o == 0))
+            out[w++] = pts[i];
+    }
+    return w;
+}
+
+/// @brief copies the points with hull_orientation(l, r, p) == side to out
+///
+/// this is the chord filter of find_hull_helper(), side 1 keeps the points above the line l->r and side 2 the points below it
+/// the floats are widened to double, the differences and products can round there, so a point whose crossproduct is within
+/// the error bound of 0 is tested again with the exact hull_orientation()
+/// @param keep_collinear also keep the points with orientation 0 (find_hull_helper() in the visualizer does)
+/// @param out receives the points, it needs room for n points (it may be the same buffer as pts)
+/// @return number of points written to out
+inline int hull_select_side(const Vector2 *pts, int n, Vector2 l, Vector2 r, int side, bool keep_collinear, Vector2 *out)
+{
+    double a = (double)r.y - l.y;
+    double b = (double)r.x - l.x;
+    int w = 0;
+    int i = 0;
+#if defined(HULL_SIMD_SSE2) || defined(HULL_SIMD_WASM)
+    /// same test as hull_orientation() on 4 points at a time, the floats are widened to two pairs of doubles
+    int keep_positive = side == 1;
+#if defined(HULL_SIMD_SSE2)
+    __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b), rx = _mm_set1_pd(r.x), ry = _mm_set1_pd(r.y);
+    __m128d zero = _mm_setzero_pd(), verror = _mm_set1_pd(hull_det_error), sign = _mm_set1_pd(-0.0);
+    /// bits 0-1 of the result are the test of the two lanes, bits 2-3 say the test was too close to call
+    auto test = [&](__m128d x, __m128d y)
+    {
+        __m128d t1 = _mm_mul_pd(va, _mm_sub_pd(x, rx)), t2 = _mm_mul_pd(vb, _mm_sub_pd(y, ry));
+        __m128d val = _mm_sub_pd(t1, t2);
+        __m128d keep = keep_positive ? _mm_cmpgt_pd(val, zero) : _mm_cmplt_pd(val, zero);
+        if (keep_collinear)
+            keep = _mm_or_pd(keep, _mm_cmpeq_pd(val, zero));
+        __m128d bound = _mm_mul_pd(verror, _mm_add_pd(_mm_andnot_pd(sign, t1), _mm_andnot_pd(sign, t2)));
+        __m128d unsure = _mm_cmple_pd(_mm_andnot_pd(sign, val), bound);
+        return _mm_movemask_pd(keep) | _mm_movemask_pd(unsure) << 2;
+    };
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 p01 = _mm_loadu_ps(&pts[i].x);
+        __m128 p23 = _mm_loadu_ps(&pts[i + 2].x);
+        __m128 x = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 y = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+        int lo = test(_mm_cvtps_pd(x), _mm_cvtps_pd(y));
+        int hi = test(_mm_cvtps_pd(_mm_movehl_ps(x, x)), _mm_cvtps_pd(_mm_movehl_ps(y, y)));
+#else
+    v128_t va = wasm_f64x2_splat(a), vb = wasm_f64x2_splat(b), rx = wasm_f64x2_splat(r.x), ry = wasm_f64x2_splat(r.y);
+    v128_t zero = wasm_f64x2_splat(0.0), verror = wasm_f64x2_splat(hull_det_error);
+    /// bits 0-1 of the result are the test of the two lanes, bits 2-3 say the test was too close to call
+    auto test = [&](v128_t x, v128_t y)
+    {
+        v128_t t1 = wasm_f64x2_mul(va, wasm_f64x2_sub(x, rx)), t2 = wasm_f64x2_mul(vb, wasm_f64x2_sub(y, ry));
+        v128_t val = wasm_f64x2_sub(t1, t2);
+        v128_t keep = keep_positive ? wasm_f64x2_gt(val, zero) : wasm_f64x2_lt(val, zero);
+        if (keep_collinear)
+            keep = wasm_v128_or(keep, wasm_f64x2_eq(val, zero));
+        v128_t bound = wasm_f64x2_mul(verror, wasm_f64x2_add(wasm_f64x2_abs(t1), wasm_f64x2_abs(t2)));
+        v128_t unsure = wasm_f64x2_le(wasm_f64x2_abs(val), bound);
+        return (int)wasm_i64x2_bitmask(keep) | (int)wasm_i64x2_bitmask(unsure) << 2;
+    };
+    for (; i + 4 <= n; i += 4)
+    {
+        v128_t p01 = wasm_v128_load(&pts[i].x);
+        v128_t p23 = wasm_v128_load(&pts[i + 2].x);
+        v128_t x = wasm_i32x4_shuffle(p01, p23, 0, 2, 4, 6);
+        v128_t y = wasm_i32x4_shuffle(p01, p23, 1, 3, 5, 7);
+        v128_t xh = wasm_i32x4_shuffle(x, x, 2, 3, 0, 1);
+        v128_t yh = wasm_i32x4_shuffle(y, y, 2, 3, 0, 1);
+        int lo = test(wasm_f64x2_promote_low_f32x4(x), wasm_f64x2_promote_low_f32x4(y));
+        int hi = test(wasm_f64x2_promote_low_f32x4(xh), wasm_f64x2_promote_low_f32x4(yh));
+#endif
+        int mask = (lo & 3) | (hi & 3) << 2;
+        int unsure = (lo >> 2) | (hi >> 2) << 2;
+        /// the block is copied before anything is written, so out may alias pts
+        Vector2 block[4] = {pts[i], pts[i + 1], pts[i + 2], pts[i + 3]};
+        for (int k = 0; k < 4; k++)
+        {
+            bool keep = mask & (1 << k);
+            if (unsure & (1 << k))
+            {
+                int o = hull_orientation(l, r, block[k]);
+                keep = o == side || (keep_collinear && o == 0);
+            }
+            if (keep)
+                out[w++] = block[k];
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        int o = hull_orientation(l, r, pts[i]);
+        if (o == side || (keep_collinear && o == 0))
+            out[w++] = pts[i];
+    }
+    return w;
+}
+
+/// @brief copies the int32 points with hull_orientation(l, r, p) == side to out
+///
+/// the vector path converts the coordinates to double (exact) but the products can round, so it also computes a bound of the
+/// rounding error: the points whose crossproduct is within that bound of 0 are tested again with the exact hull_orientation()
+inline int hull_select_side(const hull_point_i32 *pts, int n, hull_point_i32 l, hull_point_i32 r, int side, bool keep_collinear, hull_point_i32 *out)
+{
+    int w = 0;
+    int i = 0;
+#if defined(HULL_SIMD_SSE2) || defined(HULL_SIMD_WASM)
+    double a = (double)r.y - l.y;
+    double b = (double)r.x - l.x;
+    int keep_positive = side == 1;
+#if defined(HULL_SIMD_SSE2)
+    __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b), rx = _mm_set1_pd(r.x), ry = _mm_set1_pd(r.y);
+    __m128d zero = _mm_setzero_pd(), verror = _mm_set1_pd(hull_det_error), sign = _mm_set1_pd(-0.0);
+    /// bit k of the result is the test of lane k, bit k+2 says the test was too close to call
+    auto test = [&](__m128i xi, __m128i yi)
+    {
+        __m128d t1 = _mm_mul_pd(va, _mm_sub_pd(_mm_cvtepi32_pd(xi), rx));
+        __m128d t2 = _mm_mul_pd(vb, _mm_sub_pd(_mm_cvtepi32_pd(yi), ry));
+        __m128d val = _mm_sub_pd(t1, t2);
+        __m128d keep = keep_positive ? _mm_cmpgt_pd(val, zero) : _mm_cmplt_pd(val, zero);
+        if (keep_collinear)
+            keep = _mm_or_pd(keep, _mm_cmpeq_pd(val, zero));
+        __m128d bound = _mm_mul_pd(verror, _mm_add_pd(_mm_andnot_pd(sign, t1), _mm_andnot_pd(sign, t2)));
+        __m128d unsure = _mm_cmple_pd(_mm_andnot_pd(sign, val), bound);
+        return _mm_movemask_pd(keep) | _mm_movemask_pd(unsure) << 2;
+    };
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 p01 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)&pts[i]));
+        __m128 p23 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)&pts[i + 2]));
+        __m128i x = _mm_castps_si128(_mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i y = _mm_castps_si128(_mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1)));
+        int lo = test(x, y);
+        int hi = test(_mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)), _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+#else
+    v128_t va = wasm_f64x2_splat(a), vb = wasm_f64x2_splat(b), rx = wasm_f64x2_splat(r.x), ry = wasm_f64x2_splat(r.y);
+    v128_t zero = wasm_f64x2_splat(0.0), verror = wasm_f64x2_splat(hull_det_error);
+    /// bit k of the result is the test of lane k, bit k+2 says the test was too close to call
+    auto test = [&](v128_t xi, v128_t yi)
+    {
+        v128_t t1 = wasm_f64x2_mul(va, wasm_f64x2_sub(wasm_f64x2_convert_low_i32x4(xi), rx));
+        v128_t t2 = wasm_f64x2_mul(vb, wasm_f64x2_sub(wasm_f64x2_convert_low_i32x4(yi), ry));
+        v128_t val = wasm_f64x2_sub(t1, t2);
+        v128_t keep = keep_positive ? wasm_f64x2_gt(val, zero) : wasm_f64x2_lt(val, zero);
+        if (keep_collinear)
+            keep = wasm_v128_or(keep, wasm_f64x2_eq(val, zero));
+        v128_t bound = wasm_f64x2_mul(verror, wasm_f64x2_add(wasm_f64x2_abs(t1), wasm_f64x2_abs(t2)));
+        v128_t unsure = wasm_f64x2_le(wasm_f64x2_abs(val), bound);
+        return (int)wasm_i64x2_bitmask(keep) | (int)wasm_i64x2_bitmask(unsure) << 2;
+    };
+    for (; i + 4 <= n; i += 4)
+    {
+        v128_t p01 = wasm_v128_load(&pts[i].x);
+        v128_t p23 = wasm_v128_load(&pts[i + 2].x);
+        v128_t x = wasm_i32x4_shuffle(p01, p23, 0, 2, 4, 6);
+        v128_t y = wasm_i32x4_shuffle(p01, p23, 1, 3, 5, 7);
+        int lo = test(x, y);
+        int hi = test(wasm_i32x4_shuffle(x, x, 2, 3, 0, 1), wasm_i32x4_shuffle(y, y, 2, 3, 0, 1));
+#endif
+        int mask = (lo & 3) | (hi & 3) << 2;
+        int unsure = (lo >> 2) | (hi >> 2) << 2;
+        /// the block is copied before anything is written, so out may alias pts
+        hull_point_i32 block[4] = {pts[i], pts[i + 1], pts[i + 2], pts[i + 3]};
+        for (int k = 0; k < 4; k++)
+        {
+            bool keep = mask & (1 << k);
+            if (unsure & (1 << k))
+            {
+                int o = hull_orientation(l, r, block[k]);
+                keep = o == side || (keep_collinear && o == 0);
+            }
+            if (keep)
+                out[w++] = block[k];
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        int o = hull_orientation(l, r, pts[i]);
+        if (o == side || (keep_collinear && o == 0))
+            out[w++] = pts[i];
+    }
+    return w;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+/// @file jarvis_hull.h
+/// @brief non visual version of the jarvis march (gift wrapping) used in q1
+
+#include <vector>
+#include "hull_point.h"
+
+/// @brief the jarvis march, calls emit(i) with the index in pts of every hull point in order
+///
+/// the hull starts at the leftmost point (the top one if there is a tie) and goes along the upper hull from left to right
+/// and then back along the lower hull, which is the same order ks_hull() gives
+/// collinear points on an edge are not part of the output
+/// @return number of points in the hull
+template <class P, class F>
+inline int jarvis_march(const P *pts, int n, F emit)
+{
+    if (n <= 0)
+        return 0;
+    int start = 0;
+    for (int i = 1; i < n; i++)
+    {
+        if (pts[i].x < pts[start].x || (pts[i].x == pts[start].x && pts[i].y < pts[start].y))
+            start = i;
+    }
+    int h = 0;
+    int cur = start;
+    do
+    {
+        emit(cur);
+        h++;
+        int next = cur == 0 ? 1 % n : 0;
+        for (int i = 0; i < n; i++)
+        {
+            if (i == cur)
+                continue;
+            int o = hull_orientation(pts[cur], pts[next], pts[i]);
+            /// a point above the current edge means the edge is not on the hull, on a tie keep the farther point
+            if (o == 1 || (o == 0 && hull_farther(pts[cur], pts[next], pts[i])))
+                next = i;
+        }
+        /// every point is the same as the current one
+        if (pts[next].x == pts[cur].x && pts[next].y == pts[cur].y)
+            break;
+        cur = next;
+    } while ((pts[cur].x != pts[start].x || pts[cur].y != pts[start].y) && h < n);
+    return h;
+}
+
+/// @brief computes the convex hull with the jarvis march (see jarvis_march() for the order)
+/// @param pts the points (Vector2 or any point type of hull_point.h)
+/// @param n number of points
+/// @param out receives the hull, it needs room for n points
+/// @return number of points in the hull
+template <class P>
+inline int jarvis_hull(const P *pts, int n, P *out)
+{
+    P *w = out;
+    return jarvis_march(pts, n, [&](int i)
+                        { *w++ = pts[i]; });
+}
+
+/// @brief computes the convex hull with the jarvis march and gives it as indices into pts
+/// @param out receives the indices of the hull points, it needs room for n of them
+/// @return number of points in the hull
+template <class P>
+inline int jarvis_hull_indices(const P *pts, int n, int *out)
+{
+    int *w = out;
+    return jarvis_march(pts, n, [&](int i)
+                        { *w++ = i; });
+}
+
+/// @brief computes the convex hull with the jarvis march
+/// @return the points on the hull
+template <class P>
+inline std::vector<P> jarvis_hull(const std::vector<P> &points)
+{
+    std::vector<P> out(points.size());
+    out.resize(jarvis_hull(points.data(), (int)points.size(), out.data()));
+    return out;
+}
+
+/// @brief computes the convex hull with the jarvis march
+/// @return the indices of the points on the hull
+template <class P>
+inline std::vector<int> jarvis_hull_indices(const std::vector<P> &points)
+{
+    std::vector<int> out(points.size());
+    out.resize(jarvis_hull_indices(points.data(), (int)points.size(), out.data()));
+    return out;
+}
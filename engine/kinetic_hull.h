@@ -0,0 +1,204 @@
+#pragma once
+
+/// @file kinetic_hull.h
+/// @brief hull of points which move a little between two calls, warm started from the hull of the last call
+///
+/// the points which were on the last hull, taken at their new positions, span a polygon which is inside the new hull; a point
+/// which is not strictly outside that polygon cannot be a corner of the new hull, so only the old hull and the few points
+/// which crossed its edges go through Kirkpatrick-Seidel again
+/// most points are inside a box which is inside the polygon and cost four comparisons; the others are tested against the edges
+/// they were under and over at the last call first, while the motion is small those are still the right ones, and a point which
+/// moved to another edge is found again with a binary search, so a big motion only makes the call slower, the hull is always exact
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "hull_point.h"
+#include "hull_merge.h"
+#include "ks_hull.h"
+
+/// @brief keeps the hull of a set of moving points from one update() to the next
+///
+/// the points are the same from call to call (point i is the same point at a new position), a call with another number of
+/// points starts over; when several points are at the same position on a corner, the index given for it can be any of them
+template <class P = Vector2>
+class kinetic_hull
+{
+public:
+    /// @brief computes the hull of the points at their new positions
+    /// @param out receives the hull in the engine order (same as ks_hull()), it needs room for n points, can be nullptr
+    /// @return number of points in the hull
+    int update(const P *pts, int n, P *out)
+    {
+        if (n != count || !warm_start(pts))
+        {
+            /// no hull to start from (first call, other points, or the old hull collapsed to a segment)
+            count = n;
+            warm = false;
+            hull_ids.resize(std::max(n, 0));
+            hull_ids.resize(ks_hull_indices(pts, n, hull_ids.data(), ws));
+            checked = n;
+            up_hint.assign(std::max(n, 0), 0);
+            low_hint.assign(std::max(n, 0), 0);
+        }
+        if (out)
+        {
+            for (size_t i = 0; i < hull_ids.size(); i++)
+                out[i] = pts[hull_ids[i]];
+        }
+        return (int)hull_ids.size();
+    }
+
+    /// @brief computes the hull of the points at their new positions
+    /// @return the points on the hull
+    std::vector<P> update(const std::vector<P> &points)
+    {
+        std::vector<P> out(points.size());
+        out.resize(update(points.data(), (int)points.size(), out.data()));
+        return out;
+    }
+
+    /// @brief indices of the hull points of the last update(), in the engine order
+    const std::vector<int> &ids() const { return hull_ids; }
+
+    /// @brief forgets the last hull, the next update() starts from nothing
+    void reset() { count = -1; }
+
+    /// @brief true if the last update() started from the hull before it
+    bool warm_started() const { return warm; }
+
+    /// @brief number of points the last update() gave to Kirkpatrick-Seidel (all of them without a warm start)
+    int candidates() const { return checked; }
+
+private:
+    /// @brief tries the update from the last hull
+    /// @return false if the last hull is no good as a start
+    bool warm_start(const P *pts)
+    {
+        int h = (int)hull_ids.size();
+        if (h < 3)
+            return false;
+        /// the old corners at their new positions, some of them may not be corners any more
+        seed.resize(h);
+        for (int i = 0; i < h; i++)
+            seed[i] = pts[hull_ids[i]];
+        local.resize(h);
+        int s = ks_hull_indices(seed.data(), h, local.data(), ws);
+        if (s < 3)
+            return false;
+        cand_ids.clear();
+        for (int i = 0; i < s; i++)
+        {
+            cand_ids.push_back(hull_ids[local[i]]);
+            seed[i] = pts[cand_ids.back()];
+        }
+        build_chains(seed.data(), s);
+        if (upper.front().x == upper.back().x)
+            return false;
+        inner_box();
+
+        /// the corners are candidates already, testing them again is harmless (they are on the boundary, not outside)
+        for (int i = 0; i < count; i++)
+        {
+            if (outside(pts[i], up_hint[i], low_hint[i]))
+                cand_ids.push_back(i);
+        }
+        checked = (int)cand_ids.size();
+        cand.resize(checked);
+        for (int i = 0; i < checked; i++)
+            cand[i] = pts[cand_ids[i]];
+        local.resize(checked);
+        int m = ks_hull_indices(cand.data(), checked, local.data(), ws);
+        hull_ids.resize(m);
+        for (int i = 0; i < m; i++)
+            hull_ids[i] = cand_ids[local[i]];
+        warm = true;
+        return true;
+    }
+
+    /// @brief splits the polygon (in the engine order) into its upper and lower chains, both from left to right
+    void build_chains(const P *poly, int n)
+    {
+        hull_chain<P> up(poly, n, false), down(poly, n, true);
+        upper.clear();
+        lower.clear();
+        for (int k = 0; k < up.size(); k++)
+            upper.push_back(up[k]);
+        for (int k = 0; k < down.size(); k++)
+            lower.push_back(down[k]);
+    }
+
+    /// @brief finds a box inside the polygon, most points are inside it and it is tested with four comparisons
+    ///
+    /// the box spans the middle three quarters in x; in screen coordinates the upper chain is a convex function and the lower
+    /// one a concave function, so over that span the box reaches down to the higher of the two ends of the upper chain and up to
+    /// the lower of the two ends of the lower chain; it is shrunk a little so that rounding cannot put it outside the polygon
+    void inner_box()
+    {
+        double x0 = upper.front().x, x1 = upper.back().x, w = x1 - x0;
+        box_x0 = x0 + w / 8;
+        box_x1 = x1 - w / 8;
+        auto at = [&](const std::vector<P> &chain, double x)
+        {
+            int i = edge(chain, x);
+            const P &a = chain[i], &b = chain[i + 1];
+            return a.y + ((double)b.y - a.y) * (x - a.x) / ((double)b.x - a.x);
+        };
+        box_y0 = std::max(at(upper, box_x0), at(upper, box_x1));
+        box_y1 = std::min(at(lower, box_x0), at(lower, box_x1));
+        double size = std::max(std::max(std::abs(x0), std::abs(x1)), std::max(std::abs(box_y0), std::abs(box_y1)));
+        double margin = 1e-6 * (w + std::abs(box_y1 - box_y0)) + 1e-12 * size;
+        box_x0 += margin;
+        box_x1 -= margin;
+        box_y0 += margin;
+        box_y1 -= margin;
+    }
+
+    /// @brief true if p is strictly outside the polygon of the chains
+    /// @param up index of the upper edge p was under at the last call, updated
+    /// @param low index of the lower edge p was over at the last call, updated
+    bool outside(const P &p, int &up, int &low) const
+    {
+        if (p.x > box_x0 && p.x < box_x1 && p.y > box_y0 && p.y < box_y1)
+            return false;
+        if (p.x < upper.front().x || p.x > upper.back().x)
+            return true;
+        up = edge(upper, p, up);
+        if (hull_orientation(upper[up], upper[up + 1], p) == 1)
+            return true;
+        low = edge(lower, p, low);
+        return hull_orientation(lower[low + 1], lower[low], p) == 1;
+    }
+
+    /// @brief index i of the edge chain[i] -> chain[i+1] which spans p.x, the edge of the hint first
+    static int edge(const std::vector<P> &chain, const P &p, int hint) { return edge(chain, (double)p.x, hint); }
+
+    static int edge(const std::vector<P> &chain, double x, int hint = 0)
+    {
+        int last = (int)chain.size() - 2;
+        if (hint <= last && chain[hint].x <= x && x <= chain[hint + 1].x)
+            return hint;
+        int lo = 0, hi = last;
+        while (lo < hi)
+        {
+            int mid = (lo + hi + 1) / 2;
+            if (chain[mid].x <= x)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        return lo;
+    }
+
+    int count = -1;
+    bool warm = false;
+    int checked = 0;
+    std::vector<int> hull_ids;
+    /// @brief the edges each point was tested against at the last call
+    std::vector<int> up_hint, low_hint;
+    std::vector<P> seed, cand, upper, lower;
+    /// @brief the box inside the polygon, see inner_box()
+    double box_x0 = 0, box_x1 = 0, box_y0 = 0, box_y1 = 0;
+    std::vector<int> local, cand_ids;
+    ks_index_workspace_of<P> ws;
+};
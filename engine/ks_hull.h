@@ -0,0 +1,479 @@
+#pragma once
+
+/// @file ks_hull.h
+/// @brief non visual version of the Kirkpatrick-Seidel algorithm used in q2
+///
+/// it follows the same steps as Upper_hull and Lower_hull in the visualizer (median, bridge through the median, drop the points
+/// under the bridge, solve the left and right subproblems) but it works in place on scratch buffers
+/// so that computing many hulls one after the other does not allocate anything once the buffers have grown
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "hull_point.h"
+#include "hull_simd.h"
+#include "small_sort.h"
+#include "sorted_hull.h"
+#include "quick_hull.h"
+
+/// @brief how find_edge picks the slope it prunes with
+enum class ks_bridge_finder
+{
+    /// @brief median slope with the median of medians, linear in the worst case
+    median_of_medians,
+    /// @brief slope of a random pair, linear on average with a much smaller constant
+    randomized,
+};
+
+/// @brief the slope of a pair of points l, r (l.x < r.x) of a bridge round, kept as the two points: (ur - ul) / (xr - xl)
+///
+/// nothing is divided and nothing is rounded: two slopes are compared by cross multiplication with hull_det_sign(), which is
+/// exact for every coordinate type, so equal slopes are equal and there is no tolerance
+template <class T>
+struct ks_ratio
+{
+    T ul, ur, xl, xr;
+    /// both denominators are positive, so the order of the fractions is the order of the cross products
+    bool operator<(const ks_ratio &o) const { return hull_det_sign(ur, ul, o.xr, o.xl, o.ur, o.ul, xr, xl) < 0; }
+};
+
+/// @brief slope of a pair of points, and the comparison of the lines of a slope through two points
+///
+/// the line of slope du/dx through p is above the one through q when (p.u - q.u)*dx > du*(p.x - q.x), one more hull_det_sign()
+template <class P>
+struct ks_slope_traits
+{
+    typedef typename hull_point_traits<P>::wide wide;
+    typedef ks_ratio<wide> slope;
+    static slope make(wide ul, wide ur, wide xl, wide xr) { return {ul, ur, xl, xr}; }
+    /// @brief true if the line of slope k through (xp,up) is strictly above the one through (xq,uq)
+    static bool higher(const slope &k, wide up, wide xp, wide uq, wide xq) { return hull_det_sign(up, uq, k.xr, k.xl, k.ur, k.ul, xp, xq) > 0; }
+    /// @brief true if the point (xp,up) is on the line of slope k through (xq,uq)
+    static bool same_line(const slope &k, wide up, wide xp, wide uq, wide xq) { return hull_det_sign(up, uq, k.xr, k.xl, k.ur, k.ul, xp, xq) == 0; }
+};
+
+/// @brief scratch buffers used by ks_hull()
+///
+/// keep one per thread and pass it to every call, the buffers only grow
+template <class P>
+struct ks_workspace_of
+{
+    typedef typename ks_slope_traits<P>::slope slope;
+    /// @brief the bridge finder used by ks_hull()
+    ks_bridge_finder finder = ks_bridge_finder::median_of_medians;
+    /// @brief state of the random generator used by the randomized bridge finder
+    unsigned long long seed = 0x9e3779b97f4a7c15ull;
+    /// @brief copy of the points, the subproblems are partitioned in place inside it
+    std::vector<P> work;
+    /// @brief points of the current bridge problem, find_edge compacts the candidates in place
+    std::vector<P> bridge;
+    /// @brief slope of every non vertical pair in the current round
+    std::vector<slope> slopes;
+    /// @brief scratch array for the median of the slopes
+    std::vector<slope> slope_select;
+    /// @brief scratch array for the median of the x coordinates
+    std::vector<double> select;
+    /// @brief the lower hull before it is reversed into the output
+    std::vector<P> chain;
+    /// @brief the hull before it is turned into indices (ks_hull_indices())
+    std::vector<P> hull;
+    /// @brief the sorted order and the chains of sorted_hull() when compute_hull() finds the input sorted
+    std::vector<int> order, ids;
+    /// @brief the buffers of Quickhull when compute_hull() runs it
+    quick_workspace_of<P> quick;
+};
+
+/// @brief the workspace for Vector2 points
+typedef ks_workspace_of<Vector2> ks_workspace;
+
+/// @brief the workspace of ks_hull_indices() for points of type P
+template <class P>
+using ks_index_workspace_of = ks_workspace_of<hull_indexed_of<P>>;
+
+/// @brief moves the k-th smallest value of arr[0..n) to arr[k] (median of medians, O(n) worst case)
+template <class T>
+inline T ks_select(T *arr, int n, int k)
+{
+    while (n > 5)
+    {
+        /// sort every group of 5 and move its median to the front
+        int groups = 0;
+        for (int start = 0; start < n; start += 5)
+        {
+            int end = std::min(start + 5, n);
+            if (end - start == 5)
+                hull_sort_network<5>::sort(arr + start, hull_less());
+            else
+                hull_small_sort(arr + start, end - start);
+            std::swap(arr[groups++], arr[start + (end - start - 1) / 2]);
+        }
+        /// pivot is the median of the medians
+        ks_select(arr, groups, groups / 2);
+        T pivot = arr[groups / 2];
+
+        /// three way partition: smaller | equal | larger
+        int lt = 0, i = 0, gt = n;
+        while (i < gt)
+        {
+            if (arr[i] < pivot)
+                std::swap(arr[lt++], arr[i++]);
+            else if (pivot < arr[i])
+                std::swap(arr[i], arr[--gt]);
+            else
+                i++;
+        }
+        if (k < lt)
+            n = lt;
+        else if (k >= gt)
+        {
+            arr += gt;
+            k -= gt;
+            n -= gt;
+        }
+        else
+            return pivot;
+    }
+    hull_small_sort(arr, n);
+    return arr[k];
+}
+
+/// @brief side of the hull ks_hull_side computes
+///
+/// u is the "height" of a point: for the upper hull it is -y (raylib has the origin at the top left), for the lower hull it is y
+template <class P, bool Lower>
+struct ks_side
+{
+    typedef typename hull_point_traits<P>::wide wide;
+    static wide u(const P &p) { return Lower ? (wide)p.y : -(wide)p.y; }
+    /// @brief true if p is strictly above the line l->r (with respect to u)
+    static bool above(const P &l, const P &r, const P &p) { return hull_orientation(l, r, p) == (Lower ? 2 : 1); }
+};
+
+/// @brief finds the bridge (the hull edge crossing the vertical line x=a) of the m points in ws.bridge
+///
+/// same pruning as find_edge() in the visualizer: pair the points, find the median slope, find the points with the maximum
+/// intercept for that slope and drop the points which can not be the bridge
+/// @param pk receives the left end of the bridge
+/// @param pm receives the right end of the bridge
+template <class P, bool Lower>
+inline void ks_find_edge(ks_workspace_of<P> &ws, int m, double a, P &pk, P &pm)
+{
+    typedef ks_side<P, Lower> side;
+    typedef ks_slope_traits<P> line;
+    typedef typename line::slope slope_t;
+    P *p = ws.bridge.data();
+    while (true)
+    {
+        if (m <= 2)
+        {
+            if (m == 1 || p[0].x < p[1].x)
+            {
+                pk = p[0];
+                pm = p[m - 1];
+            }
+            else
+            {
+                pk = p[1];
+                pm = p[0];
+            }
+            return;
+        }
+        /// if odd number of points, the first one stays a candidate
+        int first = m % 2;
+        int pairs = (m - first) / 2;
+        ws.slopes.clear();
+        for (int i = 0; i < pairs; i++)
+        {
+            P &l = p[first + 2 * i];
+            P &r = p[first + 2 * i + 1];
+            if (r.x < l.x)
+                std::swap(l, r);
+            if (l.x != r.x)
+                ws.slopes.push_back(line::make(side::u(l), side::u(r), l.x, r.x));
+        }
+        /// if every pair is parallel to the y axis keep the upper point of each pair and try again
+        if (ws.slopes.empty())
+        {
+            int w = first;
+            for (int i = 0; i < pairs; i++)
+            {
+                P l = p[first + 2 * i];
+                P r = p[first + 2 * i + 1];
+                p[w++] = side::u(l) > side::u(r) ? l : r;
+            }
+            m = w;
+            continue;
+        }
+        slope_t median_slope;
+        if (ws.finder == ks_bridge_finder::randomized)
+        {
+            /// any slope splits the pairs, a random one drops a constant fraction of them on average (like quickselect)
+            ws.seed ^= ws.seed << 13;
+            ws.seed ^= ws.seed >> 7;
+            ws.seed ^= ws.seed << 17;
+            median_slope = ws.slopes[ws.seed % ws.slopes.size()];
+        }
+        else
+        {
+            ws.slope_select.assign(ws.slopes.begin(), ws.slopes.end());
+            int half = (int)ws.slope_select.size() / 2;
+            median_slope = ks_select(ws.slope_select.data(), (int)ws.slope_select.size(), half);
+        }
+
+        /// find the point with the highest line of the median slope and the leftmost and rightmost points on that line
+        int top = 0;
+        for (int i = 1; i < m; i++)
+        {
+            if (line::higher(median_slope, side::u(p[i]), p[i].x, side::u(p[top]), p[top].x))
+                top = i;
+        }
+        P best = p[top];
+        pk = best;
+        pm = best;
+        for (int i = 0; i < m; i++)
+        {
+            if (line::same_line(median_slope, side::u(p[i]), p[i].x, side::u(best), best.x))
+            {
+                if (p[i].x < pk.x)
+                    pk = p[i];
+                if (p[i].x > pm.x)
+                    pm = p[i];
+            }
+        }
+        /// if they lie on the opposite sides of the median this is the bridge
+        if (pk.x <= a && pm.x > a)
+            return;
+
+        /// drop the points which can not be part of the bridge, the candidates are written over the pairs already read
+        bool bridge_right = pm.x <= a;
+        int w = first;
+        int s = 0;
+        for (int i = 0; i < pairs; i++)
+        {
+            P l = p[first + 2 * i];
+            P r = p[first + 2 * i + 1];
+            if (l.x == r.x)
+            {
+                p[w++] = side::u(l) > side::u(r) ? l : r;
+                continue;
+            }
+            slope_t slope = ws.slopes[s++];
+            if (bridge_right)
+            {
+                /// equal or large slope: only the right point can be on the bridge
+                if (slope < median_slope)
+                    p[w++] = l;
+                p[w++] = r;
+            }
+            else
+            {
+                /// equal or small slope: only the left point can be on the bridge
+                p[w++] = l;
+                if (median_slope < slope)
+                    p[w++] = r;
+            }
+        }
+        m = w;
+    }
+}
+
+/// @brief below this many points (with the two ends) ks_find_hull() sorts them and runs the monotone chain instead of recursing
+const int ks_leaf_size = 16;
+
+/// @brief computes the part of the hull between l and r (both excluded) and writes it to out
+/// @param pts points strictly above the line l->r, they get reordered
+/// @param n number of points
+template <class P, bool Lower>
+inline void ks_find_hull(ks_workspace_of<P> &ws, P *pts, int n, P l, P r, P *out, int &h)
+{
+    typedef ks_side<P, Lower> side;
+    if (n == 0)
+        return;
+    if (n == 1)
+    {
+        out[h++] = pts[0];
+        return;
+    }
+    if (n + 2 <= ks_leaf_size)
+    {
+        /// a leaf: every point is strictly between l.x and r.x, so sorted by x they make a monotone chain from l to r
+        P chain[ks_leaf_size];
+        int ids[ks_leaf_size];
+        chain[0] = l;
+        std::copy(pts, pts + n, chain + 1);
+        chain[n + 1] = r;
+        hull_small_sort(chain + 1, n, [](const P &a, const P &b)
+                        { return a.x < b.x; });
+        int c = sorted_hull_chain<P, Lower>(chain, n + 2, [](int k)
+                                            { return k; }, ids, 0);
+        for (int i = 1; i + 1 < c; i++)
+            out[h++] = chain[ids[i]];
+        return;
+    }
+    /// the median of the points including the two ends, there is always a point to its right (r is the only one at r.x)
+    int m = n + 2;
+    ws.select.resize(m);
+    ws.select[0] = l.x;
+    ws.select[1] = r.x;
+    for (int i = 0; i < n; i++)
+        ws.select[i + 2] = pts[i].x;
+    double median = ks_select(ws.select.data(), m, (m - 1) / 2);
+
+    ws.bridge.resize(m);
+    ws.bridge[0] = l;
+    ws.bridge[1] = r;
+    std::copy(pts, pts + n, ws.bridge.begin() + 2);
+    P pk, pm;
+    ks_find_edge<P, Lower>(ws, m, median, pk, pm);
+
+    /// points above the left and right parts of the bridge make the two subproblems, everything under the bridge is dropped
+    P *mid = std::partition(pts, pts + n, [&](const P &p)
+                            { return p.x < pk.x && side::above(l, pk, p); });
+    P *end = std::partition(mid, pts + n, [&](const P &p)
+                            { return p.x > pm.x && side::above(pm, r, p); });
+
+    ks_find_hull<P, Lower>(ws, pts, (int)(mid - pts), l, pk, out, h);
+    if (pk.x != l.x)
+        out[h++] = pk;
+    if (pm.x != r.x)
+        out[h++] = pm;
+    ks_find_hull<P, Lower>(ws, mid, (int)(end - mid), pm, r, out, h);
+}
+
+/// @brief reads the input points as the points W the engine works on, W is an indexed point type which gets the index of the point
+template <class P, class W>
+struct ks_input
+{
+    static void load(const P *pts, int i, W &w)
+    {
+        w.x = pts[i].x;
+        w.y = pts[i].y;
+        w.id = i;
+    }
+    /// @brief copies the points strictly on the given side of l->r to out
+    static int select(const P *pts, int n, P l, P r, int side, W *out)
+    {
+        int w = 0;
+        for (int i = 0; i < n; i++)
+        {
+            if (hull_orientation(l, r, pts[i]) == side)
+                load(pts, i, out[w++]);
+        }
+        return w;
+    }
+};
+
+/// @brief the engine works on the input points themselves
+template <class P>
+struct ks_input<P, P>
+{
+    static void load(const P *pts, int i, P &w) { w = pts[i]; }
+    static int select(const P *pts, int n, P l, P r, int side, P *out) { return hull_select_side(pts, n, l, r, side, false, out); }
+};
+
+/// @brief computes the upper (or lower) hull from left to right, both ends included
+///
+/// W is the point type the engine works on: P itself, or hull_indexed_of<P> to know where the hull points are in the input
+/// @return number of points written to out
+template <class P, bool Lower, class W = P>
+inline int ks_hull_side(const P *points, int n, W *out, ks_workspace_of<W> &ws)
+{
+    typedef ks_side<P, Lower> side;
+    if (n <= 0)
+        return 0;
+    /// leftmost and rightmost points, on a tie the one which is higher for this side
+    int lo = 0, hi = 0;
+    for (int i = 1; i < n; i++)
+    {
+        if (points[i].x < points[lo].x || (points[i].x == points[lo].x && side::u(points[i]) > side::u(points[lo])))
+            lo = i;
+        if (points[i].x > points[hi].x || (points[i].x == points[hi].x && side::u(points[i]) > side::u(points[hi])))
+            hi = i;
+    }
+    W xmin, xmax;
+    ks_input<P, W>::load(points, lo, xmin);
+    ks_input<P, W>::load(points, hi, xmax);
+    int h = 0;
+    out[h++] = xmin;
+    if (xmin.x == xmax.x)
+        return h;
+
+    /// only the points above the xmin-xmax line can be part of this side of the hull
+    ws.work.resize(n);
+    ws.work.resize(ks_input<P, W>::select(points, n, points[lo], points[hi], Lower ? 2 : 1, ws.work.data()));
+    ks_find_hull<W, Lower>(ws, ws.work.data(), (int)ws.work.size(), xmin, xmax, out, h);
+    out[h++] = xmax;
+    return h;
+}
+
+/// @brief the whole hull in the engine order, on the work points W (see ks_hull_side())
+template <class P, class W>
+inline int ks_hull_work(const P *points, int n, W *out, ks_workspace_of<W> &ws)
+{
+    if (n <= 0)
+        return 0;
+    int h = ks_hull_side<P, false>(points, n, out, ws);
+    ws.chain.resize(n);
+    int lower = ks_hull_side<P, true>(points, n, ws.chain.data(), ws);
+
+    /// add the lower hull from right to left, skipping the ends it shares with the upper hull
+    int from = lower - 1;
+    int to = 0;
+    if (ws.chain[from].x == out[h - 1].x && ws.chain[from].y == out[h - 1].y)
+        from--;
+    if (ws.chain[to].x == out[0].x && ws.chain[to].y == out[0].y)
+        to++;
+    for (int i = from; i >= to; i--)
+        out[h++] = ws.chain[i];
+    return h;
+}
+
+/// @brief computes the convex hull with the Kirkpatrick-Seidel algorithm
+///
+/// the hull starts at the leftmost point (the top one if there is a tie), goes along the upper hull from left to right and comes
+/// back along the lower hull, collinear points on an edge are not part of the output
+/// @param points the points (Vector2 or any point type of hull_point.h)
+/// @param n number of points
+/// @param out receives the hull, it needs room for n points
+/// @param ws scratch buffers
+/// @return number of points in the hull
+template <class P>
+inline int ks_hull(const P *points, int n, P *out, ks_workspace_of<P> &ws) { return ks_hull_work(points, n, out, ws); }
+
+/// @brief computes the convex hull with the Kirkpatrick-Seidel algorithm and gives it as indices into points
+///
+/// same hull and order as ks_hull(), the points are read where they are and only the candidates are copied (with their index)
+/// @param out receives the indices of the hull points, it needs room for n of them
+/// @param ws scratch buffers (of indexed points)
+/// @return number of points in the hull
+template <class P>
+inline int ks_hull_indices(const P *points, int n, int *out, ks_index_workspace_of<P> &ws)
+{
+    ws.hull.resize(std::max(n, 0));
+    int h = ks_hull_work(points, n, ws.hull.data(), ws);
+    for (int i = 0; i < h; i++)
+        out[i] = ws.hull[i].id;
+    return h;
+}
+
+/// @brief computes the convex hull with the Kirkpatrick-Seidel algorithm
+/// @return the points on the hull
+template <class P>
+inline std::vector<P> ks_hull(const std::vector<P> &points)
+{
+    ks_workspace_of<P> ws;
+    std::vector<P> out(points.size());
+    out.resize(ks_hull(points.data(), (int)points.size(), out.data(), ws));
+    return out;
+}
+
+/// @brief computes the convex hull with the Kirkpatrick-Seidel algorithm
+/// @return the indices of the points on the hull
+template <class P>
+inline std::vector<int> ks_hull_indices(const std::vector<P> &points)
+{
+    ks_index_workspace_of<P> ws;
+    std::vector<int> out(points.size());
+    out.resize(ks_hull_indices(points.data(), (int)points.size(), out.data(), ws));
+    return out;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+/// @file point_quadtree.h
+/// @brief quadtree over a point set, for drawing only the part of a huge input that is on screen
+///
+/// the tree keeps its own copy of the points, reordered so that every node is a contiguous range of it
+/// a query gives the visible leaves as ranges of points and, for the nodes smaller than a given cell size, only their bounds and
+/// their number of points, which is what a viewer needs to draw a density tile instead of every point
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "hull_point.h"
+
+class point_quadtree
+{
+public:
+    /// @brief a square of the tree, its points are points()[begin..end)
+    struct node
+    {
+        float x0, y0, x1, y1;
+        uint32_t begin, end;
+        /// @brief index of the first of the four children (they are next to each other), 0 for a leaf
+        uint32_t children = 0;
+    };
+
+    /// @brief builds the tree over a copy of the points
+    /// @param leaf_size a node with at most this many points is not split
+    void build(const Vector2 *pts, size_t n, size_t leaf_size = 64)
+    {
+        items.assign(pts, pts + n);
+        nodes.clear();
+        if (n == 0)
+            return;
+        float x0 = pts[0].x, y0 = pts[0].y, x1 = x0, y1 = y0;
+        for (size_t i = 1; i < n; i++)
+        {
+            x0 = std::min(x0, pts[i].x);
+            x1 = std::max(x1, pts[i].x);
+            y0 = std::min(y0, pts[i].y);
+            y1 = std::max(y1, pts[i].y);
+        }
+        /// a square root node, so every node is a square
+        float side = std::max(std::max(x1 - x0, y1 - y0), 1e-6f);
+        nodes.push_back(node{x0, y0, x0 + side, y0 + side, 0, (uint32_t)n, 0});
+        split(0, leaf_size, 0);
+    }
+
+    /// @brief builds the tree over a copy of the points
+    void build(const std::vector<Vector2> &pts, size_t leaf_size = 64) { build(pts.data(), pts.size(), leaf_size); }
+
+    /// @brief number of points in the tree
+    size_t size() const { return items.size(); }
+
+    /// @brief the points, in the order of the tree
+    const std::vector<Vector2> &points() const { return items; }
+
+    /// @brief visits the part of the tree inside the rectangle [x0,x1]x[y0,y1]
+    ///
+    /// nodes outside the rectangle are skipped, a node smaller than cell is given to on_tile(node) when it has more than one
+    /// point, and the leaves bigger than cell are given to on_points(const Vector2 *pts, size_t n)
+    template <class Points, class Tile>
+    void query(float x0, float y0, float x1, float y1, float cell, Points on_points, Tile on_tile) const
+    {
+        if (nodes.empty())
+            return;
+        uint32_t stack[64 * 3];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const node &nd = nodes[stack[--top]];
+            if (nd.x1 < x0 || nd.x0 > x1 || nd.y1 < y0 || nd.y0 > y1)
+                continue;
+            if (nd.x1 - nd.x0 <= cell && nd.end - nd.begin > 1)
+                on_tile(nd);
+            else if (nd.children == 0)
+                on_points(items.data() + nd.begin, (size_t)(nd.end - nd.begin));
+            else
+            {
+                for (uint32_t c = 0; c < 4; c++)
+                    stack[top++] = nd.children + c;
+            }
+        }
+    }
+
+private:
+    /// @brief splits a node into four squares, the points are partitioned in place (first by y then by x)
+    void split(uint32_t index, size_t leaf_size, int depth)
+    {
+        node nd = nodes[index];
+        /// below float resolution the squares stop shrinking, so the depth is bounded too
+        if (nd.end - nd.begin <= leaf_size || depth >= 48)
+            return;
+        float mx = (nd.x0 + nd.x1) / 2, my = (nd.y0 + nd.y1) / 2;
+        Vector2 *first = items.data() + nd.begin;
+        Vector2 *last = items.data() + nd.end;
+        Vector2 *mid = std::partition(first, last, [my](const Vector2 &p)
+                                      { return p.y < my; });
+        Vector2 *top_mid = std::partition(first, mid, [mx](const Vector2 &p)
+                                          { return p.x < mx; });
+        Vector2 *bottom_mid = std::partition(mid, last, [mx](const Vector2 &p)
+                                             { return p.x < mx; });
+        uint32_t b = nd.begin;
+        uint32_t cuts[5] = {b, b + (uint32_t)(top_mid - first), b + (uint32_t)(mid - first), b + (uint32_t)(bottom_mid - first), nd.end};
+        uint32_t children = (uint32_t)nodes.size();
+        nodes[index].children = children;
+        nodes.push_back(node{nd.x0, nd.y0, mx, my, cuts[0], cuts[1], 0});
+        nodes.push_back(node{mx, nd.y0, nd.x1, my, cuts[1], cuts[2], 0});
+        nodes.push_back(node{nd.x0, my, mx, nd.y1, cuts[2], cuts[3], 0});
+        nodes.push_back(node{mx, my, nd.x1, nd.y1, cuts[3], cuts[4], 0});
+        for (uint32_t c = 0; c < 4; c++)
+            split(children + c, leaf_size, depth + 1);
+    }
+
+    std::vector<Vector2> items;
+    std::vector<node> nodes;
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+/// @file process_hull.h
+/// @brief splits one hull job between worker processes over shared memory (POSIX only)
+///
+/// the coordinator picks x bounds for the slabs from a sample and partitions the points into a shared memory segment by slab
+/// (one counting pass, one scatter pass), worker process i computes the hull of its range [begin, end) with ks_hull() and writes
+/// it back over the start of the range, then the coordinator merges the slab hulls from left to right with hull_merge()
+/// every worker can be pinned to its own set of cpus (for example one NUMA node)
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "hull_point.h"
+#include "ks_hull.h"
+#include "hull_merge.h"
+
+/// @brief how the job is split
+struct process_hull_options
+{
+    /// @brief number of worker processes (and of slabs)
+    int workers = 2;
+    /// @brief cpus of each worker, worker i is pinned to cpus[i % cpus.size()], empty means no pinning
+    ///
+    /// to give every worker its own NUMA node, put the cpu list of node i in cpus[i]
+    std::vector<std::vector<int>> cpus;
+};
+
+/// @brief pins the calling process to a set of cpus
+/// @return false if the kernel refused (for example a cpu that does not exist)
+inline bool process_hull_pin(const std::vector<int> &cpus)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        CPU_SET(c, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+/// @brief reads the cpus of every NUMA node from sysfs (linux), to be used as process_hull_options::cpus
+/// @return one cpu list per node, empty if the information is not available
+inline std::vector<std::vector<int>> process_hull_numa_nodes()
+{
+    std::vector<std::vector<int>> nodes;
+    for (int node = 0;; node++)
+    {
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *file = fopen(path, "r");
+        if (!file)
+            break;
+        /// the list looks like "0-3,8-11"
+        std::vector<int> cpus;
+        int first, last;
+        while (fscanf(file, "%d", &first) == 1)
+        {
+            last = first;
+            int c = fgetc(file);
+            if (c == '-')
+            {
+                if (fscanf(file, "%d", &last) != 1)
+                    break;
+                c = fgetc(file);
+            }
+            for (int cpu = first; cpu <= last; cpu++)
+                cpus.push_back(cpu);
+            if (c != ',')
+                break;
+        }
+        fclose(file);
+        nodes.push_back(cpus);
+    }
+    return nodes;
+}
+
+/// @brief x bounds of the slabs: slab i has the points with splitters[i] <= x < splitters[i+1]
+///
+/// the bounds are quantiles of a sample of the points, so the coordinator reads a few thousand points instead of all of them
+template <class P>
+inline std::vector<double> process_hull_splitters(const std::vector<P> &points, int workers)
+{
+    size_t n = points.size();
+    size_t samples = std::min<size_t>(n, (size_t)256 * workers);
+    std::vector<double> xs;
+    for (size_t k = 0; k < samples; k++)
+        xs.push_back((double)points[n * k / samples].x);
+    std::sort(xs.begin(), xs.end());
+    std::vector<double> splitters(workers + 1);
+    splitters[0] = -INFINITY;
+    splitters[workers] = INFINITY;
+    for (int i = 1; i < workers; i++)
+        splitters[i] = xs[xs.size() * i / workers];
+    return splitters;
+}
+
+/// @brief slab of a point: the i with splitters[i] <= x < splitters[i+1]
+inline int process_hull_slab_of(const std::vector<double> &splitters, double x)
+{
+    return (int)(std::upper_bound(splitters.begin() + 1, splitters.end() - 1, x) - splitters.begin()) - 1;
+}
+
+/// @brief copies the points of slab [lo, hi) to out
+/// @return number of points copied
+template <class P>
+inline size_t process_hull_slab(const std::vector<P> &points, double lo, double hi, P *out)
+{
+    size_t count = 0;
+    for (const P &p : points)
+    {
+        if (p.x >= lo && p.x < hi)
+            out[count++] = p;
+    }
+    return count;
+}
+
+/// @brief what the coordinator and worker i share about slab i
+struct process_hull_range
+{
+    /// @brief the points of the slab are points[begin, end) of the segment
+    uint64_t begin, end;
+    /// @brief size of the slab hull, written over points[begin, ...) by the worker
+    uint64_t size;
+};
+
+/// @brief computes the convex hull of the points with several worker processes
+///
+/// the result is the same as ks_hull() on all the points: the slabs are separated in x, so merging their hulls in order with
+/// hull_merge() gives the hull of all the points
+/// @param points the points (any point type of hull_point.h, they are copied into the segment as they are)
+/// @param options number of workers and their cpus
+/// @param hull receives the hull, in the order ks_hull() gives
+/// @return false if the shared memory or a worker could not be created (hull is then computed in this process)
+template <class P>
+inline bool process_hull(const std::vector<P> &points, const process_hull_options &options, std::vector<P> &hull)
+{
+    size_t n = points.size();
+    int workers = std::max(1, std::min(options.workers, (int)std::max<size_t>(n, 1)));
+
+    /// layout of the segment: one range per worker, then the n points grouped by slab
+    size_t header = sizeof(process_hull_range) * workers;
+    size_t bytes = header + std::max<size_t>(n, 1) * sizeof(P);
+    void *segment = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (segment == MAP_FAILED)
+    {
+        ks_workspace_of<P> ws;
+        hull.resize(n);
+        hull.resize(ks_hull(points.data(), (int)n, hull.data(), ws));
+        return false;
+    }
+    process_hull_range *ranges = (process_hull_range *)segment;
+    P *shared = (P *)((char *)segment + header);
+    std::vector<double> splitters = process_hull_splitters(points, workers);
+
+    /// partition: count the points of every slab, then scatter them to their range
+    std::vector<uint64_t> next(workers, 0);
+    for (const P &p : points)
+        next[process_hull_slab_of(splitters, (double)p.x)]++;
+    uint64_t begin = 0;
+    for (int i = 0; i < workers; i++)
+    {
+        ranges[i].begin = begin;
+        ranges[i].end = begin + next[i];
+        /// a size still at UINT64_MAX after the workers are done means that worker failed
+        ranges[i].size = UINT64_MAX;
+        next[i] = begin;
+        begin = ranges[i].end;
+    }
+    for (const P &p : points)
+        shared[next[process_hull_slab_of(splitters, (double)p.x)]++] = p;
+
+    std::vector<pid_t> children;
+    bool ok = true;
+    for (int i = 0; i < workers; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            if (!options.cpus.empty())
+                process_hull_pin(options.cpus[i % options.cpus.size()]);
+            /// the slab hull is written over the start of the range, which is not needed any more by then
+            P *slab = shared + ranges[i].begin;
+            int count = (int)(ranges[i].end - ranges[i].begin);
+            ks_workspace_of<P> ws;
+            std::vector<P> local(count);
+            int h = ks_hull(slab, count, local.data(), ws);
+            std::copy(local.begin(), local.begin() + h, slab);
+            ranges[i].size = h;
+            _exit(0);
+        }
+        if (pid < 0)
+        {
+            ok = false;
+            continue;
+        }
+        children.push_back(pid);
+    }
+    for (pid_t pid : children)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            ok = false;
+    }
+
+    /// merge the slab hulls from left to right (a slab whose worker failed is hulled here instead, from the input as its range
+    /// may be half overwritten)
+    std::vector<P> merged, scratch;
+    ks_workspace_of<P> ws;
+    for (int i = 0; i < workers; i++)
+    {
+        P *slab = shared + ranges[i].begin;
+        if (ranges[i].size == UINT64_MAX)
+        {
+            std::vector<P> local(ranges[i].end - ranges[i].begin);
+            local.resize(process_hull_slab(points, splitters[i], splitters[i + 1], local.data()));
+            ranges[i].size = ks_hull(local.data(), (int)local.size(), slab, ws);
+        }
+        int h = (int)ranges[i].size;
+        scratch.resize(merged.size() + h);
+        scratch.resize(hull_merge(merged.data(), (int)merged.size(), slab, h, scratch.data()));
+        merged.swap(scratch);
+    }
+    hull.swap(merged);
+    munmap(segment, bytes);
+    return ok;
+}
@@ -0,0 +1,334 @@
+#pragma once
+
+/// @file quick_hull.h
+/// @brief Quickhull, with the farthest point search and the partition of every level spread over a thread pool
+///
+/// each side of the hull starts from the segment between the leftmost and the rightmost point; the point farthest above a
+/// segment is on the hull, and the points above its two new edges make the two subproblems, everything else is dropped
+/// it is fast when few points are on the hull (most are dropped by the first levels) and O(n h) in the worst case
+/// the subproblems of a level are independent, so they are done together: the points of all of them are cut into pieces of
+/// grain points which never span two subproblems, one parallel loop finds the farthest point of every piece and a second one
+/// partitions the pieces; the pieces are reduced in order, so the hull is the same for any number of threads
+/// the points are kept above an edge with hull_orientation(), the predicate of Upper_hull::orientation() and of the other
+/// engines, so the engines agree on the collinear and duplicate points
+
+#include <algorithm>
+#include <vector>
+#include "hull_point.h"
+#include "thread_pool.h"
+
+/// @brief a subproblem of one side of the hull: the points strictly above l->r are work[begin, end)
+template <class W>
+struct quick_segment
+{
+    W l, r;
+    int begin, end;
+};
+
+/// @brief points of one subproblem that one worker does in a loop
+struct quick_piece
+{
+    int segment, begin, end;
+    /// @brief the farthest point of the piece, an index into work (-1 when the piece is empty)
+    int best;
+    /// @brief number of points above the left and the right new edge, and where they go in the next level
+    int left, right, left_at, right_at;
+};
+
+/// @brief scratch buffers of quick_hull_work(), keep one per thread, they only grow
+template <class W>
+struct quick_workspace_of
+{
+    /// @brief points of a loop piece, smaller pieces spread better over the threads but cost more to reduce
+    int grain = 1 << 13;
+    std::vector<W> work, scratch, found, chain;
+    std::vector<quick_segment<W>> segments, next;
+    std::vector<quick_piece> pieces;
+};
+
+/// @brief reads input point i as the work point W, an indexed point gets its index
+template <class P, class W>
+inline void quick_load(const P *pts, int i, W &w)
+{
+    w.x = pts[i].x;
+    w.y = pts[i].y;
+    w.id = i;
+}
+
+template <class P>
+inline void quick_load(const P *pts, int i, P &w) { w = pts[i]; }
+
+/// @brief calls fn(i) for i in [0, count), on the pool when there is one
+template <class F>
+inline void quick_for(hull_thread_pool *pool, size_t count, F fn)
+{
+    if (!pool)
+    {
+        for (size_t i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+    pool->parallel_for(count, 1, [&](unsigned, size_t begin, size_t end)
+                       {
+        for (size_t i = begin; i < end; i++)
+            fn(i); });
+}
+
+/// @brief computes the upper (or lower) hull from left to right, both ends included, same output as ks_hull_side()
+/// @return number of points written to out
+template <class P, bool Lower, class W>
+inline int quick_hull_side(const P *points, int n, W *out, quick_workspace_of<W> &ws, hull_thread_pool *pool)
+{
+    typedef typename hull_point_traits<P>::wide wide;
+    auto u = [](const P &p)
+    { return Lower ? (wide)p.y : -(wide)p.y; };
+    const int above = Lower ? 2 : 1;
+    /// sign of how much farther above l->r p is than q: the heights (the values whose sign hull_orientation() gives) differ by
+    /// (r.y - l.y)*(p.x - q.x) - (r.x - l.x)*(p.y - q.y), which hull_det_sign() gives exactly, so near ties are never rounded
+    auto farther = [](const W &l, const W &r, const W &p, const W &q)
+    {
+        int sign = hull_det_sign((wide)r.y, (wide)l.y, (wide)p.x, (wide)q.x, (wide)r.x, (wide)l.x, (wide)p.y, (wide)q.y);
+        return Lower ? -sign : sign;
+    };
+    if (n <= 0)
+        return 0;
+    int grain = std::max(ws.grain, 1);
+    int count = (n + grain - 1) / grain;
+    ws.pieces.assign(count, quick_piece());
+
+    /// leftmost and rightmost points (on a tie the highest for this side) of every piece, then of all of them
+    quick_for(pool, count, [&](size_t k)
+              {
+        quick_piece &piece = ws.pieces[k];
+        int begin = (int)k * grain, end = std::min(n, begin + grain);
+        int lo = begin, hi = begin;
+        for (int i = begin + 1; i < end; i++)
+        {
+            if (points[i].x < points[lo].x || (points[i].x == points[lo].x && u(points[i]) > u(points[lo])))
+                lo = i;
+            if (points[i].x > points[hi].x || (points[i].x == points[hi].x && u(points[i]) > u(points[hi])))
+                hi = i;
+        }
+        piece.left = lo;
+        piece.right = hi; });
+    int lo = ws.pieces[0].left, hi = ws.pieces[0].right;
+    for (int k = 1; k < count; k++)
+    {
+        int a = ws.pieces[k].left, b = ws.pieces[k].right;
+        if (points[a].x < points[lo].x || (points[a].x == points[lo].x && u(points[a]) > u(points[lo])))
+            lo = a;
+        if (points[b].x > points[hi].x || (points[b].x == points[hi].x && u(points[b]) > u(points[hi])))
+            hi = b;
+    }
+    W l, r;
+    quick_load(points, lo, l);
+    quick_load(points, hi, r);
+    int h = 0;
+    out[h++] = l;
+    if (l.x == r.x)
+        return h;
+
+    /// the points above l->r, every piece compacts its own range of scratch and the ranges are then put end to end in work
+    ws.scratch.resize(n);
+    ws.work.resize(n);
+    quick_for(pool, count, [&](size_t k)
+              {
+        int begin = (int)k * grain, end = std::min(n, begin + grain), w = begin;
+        for (int i = begin; i < end; i++)
+        {
+            if (hull_orientation(points[lo], points[hi], points[i]) == above)
+                quick_load(points, i, ws.scratch[w++]);
+        }
+        ws.pieces[k].left = w - begin; });
+    int m = 0;
+    for (int k = 0; k < count; k++)
+    {
+        ws.pieces[k].left_at = m;
+        m += ws.pieces[k].left;
+    }
+    quick_for(pool, count, [&](size_t k)
+              {
+        int begin = (int)k * grain;
+        std::copy(ws.scratch.begin() + begin, ws.scratch.begin() + begin + ws.pieces[k].left, ws.work.begin() + ws.pieces[k].left_at); });
+
+    ws.found.clear();
+    ws.segments.clear();
+    if (m > 0)
+        ws.segments.push_back({l, r, 0, m});
+    while (!ws.segments.empty())
+    {
+        ws.pieces.clear();
+        for (int s = 0; s < (int)ws.segments.size(); s++)
+        {
+            const quick_segment<W> &seg = ws.segments[s];
+            for (int b = seg.begin; b < seg.end; b += grain)
+                ws.pieces.push_back({s, b, std::min(seg.end, b + grain), -1, 0, 0, 0, 0});
+        }
+
+        /// the farthest point of every piece, on a tie the leftmost one (the points between are on an edge)
+        quick_for(pool, ws.pieces.size(), [&](size_t k)
+                  {
+            quick_piece &piece = ws.pieces[k];
+            const quick_segment<W> &seg = ws.segments[piece.segment];
+            int best = piece.begin;
+            for (int i = piece.begin + 1; i < piece.end; i++)
+            {
+                int c = farther(seg.l, seg.r, ws.work[i], ws.work[best]);
+                if (c > 0 || (c == 0 && ws.work[i].x < ws.work[best].x))
+                    best = i;
+            }
+            piece.best = best; });
+        /// the same rule over the pieces of each segment, in order
+        for (size_t k = 0; k < ws.pieces.size(); k++)
+        {
+            quick_piece &piece = ws.pieces[k];
+            if (k == 0 || ws.pieces[k - 1].segment != piece.segment)
+                continue;
+            const quick_segment<W> &seg = ws.segments[piece.segment];
+            int prev = ws.pieces[k - 1].best;
+            int c = farther(seg.l, seg.r, ws.work[piece.best], ws.work[prev]);
+            if (!(c > 0 || (c == 0 && ws.work[piece.best].x < ws.work[prev].x)))
+                piece.best = prev;
+        }
+        /// the last piece of a segment holds its farthest point, every piece gets it
+        for (size_t k = ws.pieces.size(); k-- > 1;)
+        {
+            if (ws.pieces[k - 1].segment == ws.pieces[k].segment)
+                ws.pieces[k - 1].best = ws.pieces[k].best;
+        }
+
+        /// every piece keeps the points above l->f at the front of its range of scratch and those above f->r at the back
+        quick_for(pool, ws.pieces.size(), [&](size_t k)
+                  {
+            quick_piece &piece = ws.pieces[k];
+            const quick_segment<W> &seg = ws.segments[piece.segment];
+            W f = ws.work[piece.best];
+            int left = piece.begin, right = piece.end;
+            for (int i = piece.begin; i < piece.end; i++)
+            {
+                const W &p = ws.work[i];
+                if (hull_orientation(seg.l, f, p) == above)
+                    ws.scratch[left++] = p;
+                else if (hull_orientation(f, seg.r, p) == above)
+                    ws.scratch[--right] = p;
+            }
+            piece.left = left - piece.begin;
+            piece.right = piece.end - right; });
+
+        /// the next level: the two subproblems of each segment, in order, and where the pieces put their points
+        ws.next.clear();
+        int pos = 0;
+        for (size_t first = 0; first < ws.pieces.size();)
+        {
+            size_t last = first;
+            while (last < ws.pieces.size() && ws.pieces[last].segment == ws.pieces[first].segment)
+                last++;
+            const quick_segment<W> &seg = ws.segments[ws.pieces[first].segment];
+            W f = ws.work[ws.pieces[first].best];
+            ws.found.push_back(f);
+            int begin = pos;
+            for (size_t k = first; k < last; k++)
+            {
+                ws.pieces[k].left_at = pos;
+                pos += ws.pieces[k].left;
+            }
+            if (pos > begin)
+                ws.next.push_back({seg.l, f, begin, pos});
+            begin = pos;
+            for (size_t k = first; k < last; k++)
+            {
+                ws.pieces[k].right_at = pos;
+                pos += ws.pieces[k].right;
+            }
+            if (pos > begin)
+                ws.next.push_back({f, seg.r, begin, pos});
+            first = last;
+        }
+        quick_for(pool, ws.pieces.size(), [&](size_t k)
+                  {
+            const quick_piece &piece = ws.pieces[k];
+            std::copy(ws.scratch.begin() + piece.begin, ws.scratch.begin() + piece.begin + piece.left, ws.work.begin() + piece.left_at);
+            std::copy(ws.scratch.begin() + piece.end - piece.right, ws.scratch.begin() + piece.end, ws.work.begin() + piece.right_at); });
+        ws.segments.swap(ws.next);
+    }
+
+    /// the points found are all strictly between l and r in x and on one chain, so sorted by x they are the chain
+    std::sort(ws.found.begin(), ws.found.end(), [](const W &a, const W &b)
+              { return a.x < b.x; });
+    for (const W &p : ws.found)
+        out[h++] = p;
+    out[h++] = r;
+    return h;
+}
+
+/// @brief the whole hull in the engine order on the work points W (P itself, or hull_indexed_of<P>)
+/// @param pool runs the loops of every level on it, nullptr runs them on the calling thread
+template <class P, class W>
+inline int quick_hull_work(const P *points, int n, W *out, quick_workspace_of<W> &ws, hull_thread_pool *pool = nullptr)
+{
+    if (n <= 0)
+        return 0;
+    int h = quick_hull_side<P, false>(points, n, out, ws, pool);
+    ws.chain.resize(n);
+    int lower = quick_hull_side<P, true>(points, n, ws.chain.data(), ws, pool);
+
+    /// add the lower hull from right to left, skipping the ends it shares with the upper hull
+    int from = lower - 1;
+    int to = 0;
+    if (ws.chain[from].x == out[h - 1].x && ws.chain[from].y == out[h - 1].y)
+        from--;
+    if (ws.chain[to].x == out[0].x && ws.chain[to].y == out[0].y)
+        to++;
+    for (int i = from; i >= to; i--)
+        out[h++] = ws.chain[i];
+    return h;
+}
+
+/// @brief computes big hulls with Quickhull on a thread pool
+///
+/// same hull and order as ks_hull(); compute_hull() with hull_engine::quickhull runs the same code on the calling thread
+template <class P = Vector2>
+class quick_hull
+{
+public:
+    /// @param threads number of threads, 0 means one per hardware thread
+    explicit quick_hull(unsigned threads = 0) : pool(threads) {}
+
+    /// @brief computes the convex hull of the points
+    /// @param out receives the hull, it needs room for n points
+    /// @return number of points in the hull
+    int run(const P *points, int n, P *out) { return quick_hull_work(points, n, out, plain, &pool); }
+
+    /// @brief computes the convex hull of the points and gives it as indices into points, same order as run()
+    /// @param out receives the indices of the hull points, it needs room for n of them
+    /// @return number of points in the hull
+    int run_indices(const P *points, int n, int *out)
+    {
+        hull.resize(std::max(n, 0));
+        int h = quick_hull_work(points, n, hull.data(), indexed, &pool);
+        for (int i = 0; i < h; i++)
+            out[i] = hull[i].id;
+        return h;
+    }
+
+    /// @brief computes the convex hull of the points
+    /// @return the points on the hull
+    std::vector<P> run(const std::vector<P> &points)
+    {
+        std::vector<P> out(points.size());
+        out.resize(run(points.data(), (int)points.size(), out.data()));
+        return out;
+    }
+
+    /// @brief number of threads
+    unsigned threads() const { return pool.size(); }
+
+    /// @brief points of a loop piece (see quick_workspace_of::grain)
+    void set_grain(int grain) { plain.grain = indexed.grain = grain; }
+
+private:
+    hull_thread_pool pool;
+    quick_workspace_of<P> plain;
+    quick_workspace_of<hull_indexed_of<P>> indexed;
+    std::vector<hull_indexed_of<P>> hull;
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+/// @file small_sort.h
+/// @brief sorts of a handful of values without calls: sorting networks up to 5, unrolled insertion sort from 6 to 8 and a plain
+/// insertion sort up to 16
+///
+/// the median of medians sorts millions of groups of 5 and the leaves of the recursions sort a few points, std::sort spends
+/// more on its call, its size checks and its mispredicted branches than on the comparisons there
+/// a network always does the same compare-exchanges, and a compare-exchange is written as two selects, which the compiler
+/// turns into min/max or conditional moves for numbers, so a group of 5 is sorted with 9 of them and no branch at all
+
+#include <algorithm>
+
+/// @brief the order of the values, operator<
+struct hull_less
+{
+    template <class T>
+    bool operator()(const T &a, const T &b) const { return a < b; }
+};
+
+/// @brief puts a and b in order (the smaller one in a), without a branch
+template <class T, class Less>
+inline void hull_compare_exchange(T &a, T &b, Less less)
+{
+    bool swap = less(b, a);
+    T lo = swap ? b : a;
+    T hi = swap ? a : b;
+    a = lo;
+    b = hi;
+}
+
+/// @brief sorting network for N values, the best known one (fewest compare-exchanges) for each N
+template <int N>
+struct hull_sort_network;
+
+template <>
+struct hull_sort_network<0>
+{
+    template <class T, class Less>
+    static void sort(T *, Less) {}
+};
+
+template <>
+struct hull_sort_network<1>
+{
+    template <class T, class Less>
+    static void sort(T *, Less) {}
+};
+
+template <>
+struct hull_sort_network<2>
+{
+    template <class T, class Less>
+    static void sort(T *a, Less less) { hull_compare_exchange(a[0], a[1], less); }
+};
+
+template <>
+struct hull_sort_network<3>
+{
+    template <class T, class Less>
+    static void sort(T *a, Less less)
+    {
+        hull_compare_exchange(a[1], a[2], less);
+        hull_compare_exchange(a[0], a[2], less);
+        hull_compare_exchange(a[0], a[1], less);
+    }
+};
+
+template <>
+struct hull_sort_network<4>
+{
+    template <class T, class Less>
+    static void sort(T *a, Less less)
+    {
+        hull_compare_exchange(a[0], a[1], less);
+        hull_compare_exchange(a[2], a[3], less);
+        hull_compare_exchange(a[0], a[2], less);
+        hull_compare_exchange(a[1], a[3], less);
+        hull_compare_exchange(a[1], a[2], less);
+    }
+};
+
+template <>
+struct hull_sort_network<5>
+{
+    template <class T, class Less>
+    static void sort(T *a, Less less)
+    {
+        hull_compare_exchange(a[0], a[1], less);
+        hull_compare_exchange(a[3], a[4], less);
+        hull_compare_exchange(a[2], a[4], less);
+        hull_compare_exchange(a[2], a[3], less);
+        hull_compare_exchange(a[0], a[3], less);
+        hull_compare_exchange(a[0], a[2], less);
+        hull_compare_exchange(a[1], a[4], less);
+        hull_compare_exchange(a[1], a[3], less);
+        hull_compare_exchange(a[1], a[2], less);
+    }
+};
+
+/// @brief insertion sort of exactly N values, the loops have constant bounds so the compiler unrolls them
+template <int N, class T, class Less>
+inline void hull_insertion_sort_n(T *a, Less less)
+{
+    for (int i = 1; i < N; i++)
+    {
+        T v = a[i];
+        int j = i;
+        while (j > 0 && less(v, a[j - 1]))
+        {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = v;
+    }
+}
+
+/// @brief largest n hull_small_sort() handles without std::sort
+const int hull_small_sort_limit = 16;
+
+/// @brief sorts a[0..n), with a network up to 5 values, an unrolled insertion sort up to 8 and an insertion sort loop up to
+/// hull_small_sort_limit
+template <class T, class Less>
+inline void hull_small_sort(T *a, int n, Less less)
+{
+    switch (n)
+    {
+    case 0:
+    case 1:
+        return;
+    case 2:
+        return hull_sort_network<2>::sort(a, less);
+    case 3:
+        return hull_sort_network<3>::sort(a, less);
+    case 4:
+        return hull_sort_network<4>::sort(a, less);
+    case 5:
+        return hull_sort_network<5>::sort(a, less);
+    case 6:
+        return hull_insertion_sort_n<6>(a, less);
+    case 7:
+        return hull_insertion_sort_n<7>(a, less);
+    case 8:
+        return hull_insertion_sort_n<8>(a, less);
+    default:
+        if (n <= hull_small_sort_limit)
+        {
+            for (int i = 1; i < n; i++)
+            {
+                T v = a[i];
+                int j = i;
+                while (j > 0 && less(v, a[j - 1]))
+                {
+                    a[j] = a[j - 1];
+                    j--;
+                }
+                a[j] = v;
+            }
+        }
+        else
+            std::sort(a, a + n, less);
+    }
+}
+
+/// @brief sorts a[0..n) with operator<
+template <class T>
+inline void hull_small_sort(T *a, int n) { hull_small_sort(a, n, hull_less()); }
@@ -0,0 +1,168 @@
+#pragma once
+
+/// @file sorted_hull.h
+/// @brief linear time hull of points which are sorted by x, or nearly (monotone chain)
+///
+/// many inputs come sorted by x already (scans ordered by time, the output of a sort done for something else), for those the
+/// median of Kirkpatrick-Seidel is not needed at all: the upper and the lower hull each come from one scan with a stack
+/// hull_presorted() says cheaply if an input is sorted, or so close to it that an insertion sort of its indices is linear
+
+#include <algorithm>
+#include <vector>
+#include "hull_point.h"
+
+/// @brief how the points of an input are ordered, as found by hull_presorted()
+enum class hull_input_order
+{
+    /// @brief sorted by x (the points with the same x in any order)
+    sorted,
+    /// @brief a few points out of place, an insertion sort puts them back in linear time
+    nearly_sorted,
+    /// @brief anything else
+    unsorted,
+};
+
+/// @brief an input with more descents than n/hull_nearly_sorted_ratio is not nearly sorted
+const int hull_nearly_sorted_ratio = 64;
+
+/// @brief finds out if pts is sorted by x, counting the descents (pts[i].x < pts[i-1].x)
+///
+/// the count stops as soon as there are too many for nearly_sorted, so a random input is told apart in a few points
+template <class P>
+inline hull_input_order hull_presorted(const P *pts, int n)
+{
+    int limit = n / hull_nearly_sorted_ratio, descents = 0;
+    for (int i = 1; i < n; i++)
+    {
+        if (pts[i].x < pts[i - 1].x && ++descents > limit)
+            return hull_input_order::unsorted;
+    }
+    return descents == 0 ? hull_input_order::sorted : hull_input_order::nearly_sorted;
+}
+
+/// @brief sorts the indices 0..n-1 of pts by x with an insertion sort
+///
+/// the cost is n plus the distance the points move, which is small for a nearly sorted input; above max_moves it gives up
+/// @return false if it gave up (order is then only partly sorted)
+template <class P>
+inline bool hull_insertion_sort(const P *pts, int n, std::vector<int> &order, long long max_moves)
+{
+    order.resize(n);
+    long long moves = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int j = i;
+        while (j > 0 && pts[i].x < pts[order[j - 1]].x)
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+        moves += i - j;
+        if (moves > max_moves)
+            return false;
+    }
+    return true;
+}
+
+/// @brief builds the upper (or lower) hull of the points pts[at(0)], pts[at(1)]... which are sorted by x
+///
+/// the chain is left in ids[from..), from the leftmost point to the rightmost one, with the same ends as ks_hull_side()
+/// (the highest point of the first and of the last column for this side) and without collinear points
+/// @return number of points in the chain
+template <class P, bool Lower, class F>
+inline int sorted_hull_chain(const P *pts, int n, F at, int *ids, int from)
+{
+    typedef typename hull_point_traits<P>::wide wide;
+    auto u = [](const P &p)
+    { return Lower ? (wide)p.y : -(wide)p.y; };
+    const int above = Lower ? 2 : 1;
+    int top = from;
+    for (int k = 0; k < n; k++)
+    {
+        int i = at(k);
+        const P &p = pts[i];
+        if (top > from && pts[ids[top - 1]].x == p.x)
+        {
+            /// only the highest point of a column can be on the chain, and a higher one pops what the lower one would
+            if (u(p) <= u(pts[ids[top - 1]]))
+                continue;
+            top--;
+        }
+        /// the middle point stays only if it is strictly above the line from the one before it to p
+        while (top - from >= 2 && hull_orientation(pts[ids[top - 2]], p, pts[ids[top - 1]]) != above)
+            top--;
+        ids[top++] = i;
+    }
+    return top - from;
+}
+
+/// @brief computes the hull of points sorted by x (or in the order given by at) as indices, in the engine order
+/// @param at at(k) is the index of the k-th point from the left
+/// @param ids receives the indices of the hull points, it needs room for 2n of them
+/// @return number of points in the hull
+template <class P, class F>
+inline int sorted_hull_ids(const P *pts, int n, F at, int *ids)
+{
+    if (n <= 0)
+        return 0;
+    int h = sorted_hull_chain<P, false>(pts, n, at, ids, 0);
+    int lower = sorted_hull_chain<P, true>(pts, n, at, ids, h);
+
+    /// add the lower hull from right to left, skipping the ends it shares with the upper hull
+    int from = h + lower - 1;
+    int to = h;
+    const P &first = pts[ids[0]], &last = pts[ids[h - 1]];
+    if (pts[ids[from]].x == last.x && pts[ids[from]].y == last.y)
+        from--;
+    if (pts[ids[to]].x == first.x && pts[ids[to]].y == first.y)
+        to++;
+    /// the chain is reversed and moved down to start right after the upper hull
+    if (to <= from)
+    {
+        std::reverse(ids + to, ids + from + 1);
+        std::copy(ids + to, ids + from + 1, ids + h);
+        h += from + 1 - to;
+    }
+    return h;
+}
+
+/// @brief computes the hull of points sorted by x (or in the order given by order) as indices, in the engine order
+/// @param order the indices of the points sorted by x, nullptr if pts itself is sorted
+/// @param ids receives the indices of the hull points
+/// @return number of points in the hull
+template <class P>
+inline int sorted_hull_ids(const P *pts, int n, const int *order, std::vector<int> &ids)
+{
+    ids.resize(2 * (size_t)std::max(n, 0));
+    auto at = [order](int k)
+    { return order ? order[k] : k; };
+    int h = sorted_hull_ids(pts, n, at, ids.data());
+    ids.resize(h);
+    return h;
+}
+
+/// @brief computes the hull of points sorted by x in O(n), same hull and order as ks_hull()
+/// @param order the indices of the points sorted by x, nullptr if pts itself is sorted
+/// @param out receives the hull, it needs room for n points
+/// @param ids scratch buffer
+/// @return number of points in the hull
+template <class P>
+inline int sorted_hull(const P *pts, int n, const int *order, P *out, std::vector<int> &ids)
+{
+    int h = sorted_hull_ids(pts, n, order, ids);
+    for (int i = 0; i < h; i++)
+        out[i] = pts[ids[i]];
+    return h;
+}
+
+/// @brief computes the hull of points sorted by x in O(n)
+/// @return the points on the hull
+template <class P>
+inline std::vector<P> sorted_hull(const std::vector<P> &points)
+{
+    std::vector<int> ids;
+    std::vector<P> out(points.size());
+    out.resize(sorted_hull(points.data(), (int)points.size(), nullptr, out.data(), ids));
+    return out;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+/// @file stream_hull.h
+/// @brief convex hull of inputs which do not fit in memory
+///
+/// the points are read in chunks of a fixed size, each chunk is hulled together with the hull found so far and only that hull is kept
+/// (a point inside the hull of some points can not be on the hull of a bigger set), so the memory is the chunk plus O(h)
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <future>
+#include <vector>
+#include "hull_point.h"
+#include "ks_hull.h"
+
+/// @brief keeps the hull of all the points added so far
+template <class P = Vector2>
+class stream_hull
+{
+public:
+    typedef typename hull_point_traits<P>::coord coord;
+
+    /// @param chunk_points number of points buffered before they are hulled
+    explicit stream_hull(size_t chunk_points = 1 << 20) : chunk_size(chunk_points ? chunk_points : 1)
+    {
+        chunk.reserve(chunk_size);
+    }
+
+    /// @brief adds points, they are copied so the caller can reuse its buffer
+    void add(const P *pts, size_t n)
+    {
+        while (n > 0)
+        {
+            size_t take = std::min(n, chunk_size - chunk.size());
+            chunk.insert(chunk.end(), pts, pts + take);
+            pts += take;
+            n -= take;
+            if (chunk.size() == chunk_size)
+                flush();
+        }
+    }
+
+    /// @brief hulls a full chunk given by the caller without copying it
+    ///
+    /// used by stream_hull_file() which reads straight into its own buffers
+    void add_chunk(std::vector<P> &pts)
+    {
+        merge(pts);
+    }
+
+    /// @brief the hull of everything added so far, in the order ks_hull() gives
+    const std::vector<P> &hull()
+    {
+        flush();
+        return current;
+    }
+
+    /// @brief number of points added so far
+    size_t points_seen() const { return seen + chunk.size(); }
+
+private:
+    /// @brief hulls the buffered points together with the current hull
+    void flush()
+    {
+        if (chunk.empty())
+            return;
+        merge(chunk);
+        chunk.clear();
+    }
+
+    /// @brief replaces the current hull by the hull of the current hull and pts
+    void merge(std::vector<P> &pts)
+    {
+        seen += pts.size();
+        drop_inside(pts);
+        size_t n = pts.size();
+        /// reserve the chunk plus twice the hull: the hull is small next to a chunk, so this costs little, while letting
+        /// insert() grow the buffer could double the memory of a chunk; the slack keeps a growing hull from reallocating every time
+        if (pts.capacity() < n + current.size())
+            pts.reserve(n + 2 * current.size());
+        pts.insert(pts.end(), current.begin(), current.end());
+        current.resize(pts.size());
+        current.resize(ks_hull(pts.data(), (int)pts.size(), current.data(), ws));
+        pts.resize(n);
+    }
+
+    /// @brief drops the points strictly inside the current hull
+    ///
+    /// after the first chunks nearly every point is inside the hull, finding the edges above and below a point is a binary search
+    /// on the upper and the lower hull, which is much cheaper than letting KS look at the point
+    void drop_inside(std::vector<P> &pts)
+    {
+        int h = (int)current.size();
+        if (h < 3)
+            return;
+        /// the upper hull is current[0..r] (x going up), the lower hull is current[r..h-1] and then current[0] (x going down)
+        int r = 0;
+        for (int i = 1; i < h; i++)
+        {
+            if (current[i].x > current[r].x)
+                r = i;
+        }
+        const P *upper = current.data();
+        const P *lower = current.data() + r;
+        int lower_n = h - r;
+        coord left = current[0].x, right = current[r].x;
+        size_t w = 0;
+        for (size_t i = 0; i < pts.size(); i++)
+        {
+            P p = pts[i];
+            bool inside = false;
+            if (p.x > left && p.x < right)
+            {
+                /// first upper point to the right of p and first lower point to the left of p
+                int a = (int)(std::upper_bound(upper, upper + r + 1, p.x, [](coord x, const P &q)
+                                               { return x < q.x; }) -
+                              upper);
+                int b = (int)(std::upper_bound(lower, lower + lower_n, p.x, [](coord x, const P &q)
+                                               { return x > q.x; }) -
+                              lower);
+                P lb = b < lower_n ? lower[b] : current[0];
+                /// the hull goes clockwise on screen, so a point inside is on side 2 of both edges
+                inside = hull_orientation(upper[a - 1], upper[a], p) == 2 && hull_orientation(lower[b - 1], lb, p) == 2;
+            }
+            if (!inside)
+                pts[w++] = p;
+        }
+        pts.resize(w);
+    }
+
+    size_t chunk_size;
+    size_t seen = 0;
+    std::vector<P> chunk;
+    std::vector<P> current;
+    ks_workspace_of<P> ws;
+};
+
+/// @brief reads up to max points from a file
+///
+/// binary files are raw pairs of little endian float32 (x then y), text files have one "x y" per line
+/// @return number of points read, less than max only at the end of the file
+inline size_t stream_read_points(FILE *file, bool text, Vector2 *out, size_t max)
+{
+    if (!text)
+        return fread(out, sizeof(Vector2), max, file);
+    size_t n = 0;
+    float x, y;
+    while (n < max && fscanf(file, "%f %f", &x, &y) == 2)
+    {
+        out[n].x = x;
+        out[n].y = y;
+        n++;
+    }
+    return n;
+}
+
+/// @brief computes the hull of a file of points with bounded memory
+///
+/// the next chunk is read on another thread while the current one is hulled, so for big chunks the time is the time it
+/// takes to read the file
+/// @param path the file, it is read as text if the name ends with .txt
+/// @param chunk_points number of points hulled at a time
+/// @param hull receives the hull
+/// @return number of points in the file, or -1 if it can not be opened
+inline long long stream_hull_file(const char *path, size_t chunk_points, std::vector<Vector2> &hull)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        printf("Failed to open file %s\n", path);
+        return -1;
+    }
+    size_t len = strlen(path);
+    bool text = len >= 4 && strcmp(path + len - 4, ".txt") == 0;
+    if (chunk_points == 0)
+        chunk_points = 1;
+
+    stream_hull<> stream(chunk_points);
+    /// two buffers: one is read while the other one is hulled (room for the hull is added by stream_hull)
+    std::vector<Vector2> buffers[2];
+    auto read = [&](int b)
+    {
+        buffers[b].resize(chunk_points);
+        buffers[b].resize(stream_read_points(file, text, buffers[b].data(), chunk_points));
+        return buffers[b].size();
+    };
+    int cur = 0;
+    read(cur);
+    while (!buffers[cur].empty())
+    {
+        std::future<size_t> next = std::async(std::launch::async, read, 1 - cur);
+        stream.add_chunk(buffers[cur]);
+        next.get();
+        cur = 1 - cur;
+    }
+    fclose(file);
+    hull = stream.hull();
+    return (long long)stream.points_seen();
+}
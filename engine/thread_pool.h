@@ -0,0 +1,124 @@
+#pragma once
+
+/// @file thread_pool.h
+/// @brief a small fixed size thread pool used by the parallel engines
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+/// @brief fixed set of worker threads which run parallel loops
+///
+/// the threads are started once and sleep between loops, so a loop only costs a wake up instead of creating threads
+/// the calling thread also works on the loop, it is worker 0
+class hull_thread_pool
+{
+public:
+    /// @param threads number of workers including the calling thread, 0 means one per hardware thread
+    explicit hull_thread_pool(unsigned threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < threads; i++)
+            workers.emplace_back([this, i]
+                                 { worker_loop(i); });
+    }
+
+    ~hull_thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &t : workers)
+            t.join();
+    }
+
+    hull_thread_pool(const hull_thread_pool &) = delete;
+    hull_thread_pool &operator=(const hull_thread_pool &) = delete;
+
+    /// @brief number of workers including the calling thread
+    unsigned size() const { return (unsigned)workers.size() + 1; }
+
+    /// @brief calls fn(worker, begin, end) for chunks of [0,count) until all of it is done
+    ///
+    /// the chunks are claimed with an atomic counter so fast workers take more of them
+    /// only one thread may start loops on a pool, and fn must not start another loop on the same pool
+    /// @param grain size of one chunk
+    /// @param fn called as fn(unsigned worker, size_t begin, size_t end)
+    template <class F>
+    void parallel_for(size_t count, size_t grain, F fn)
+    {
+        if (count == 0)
+            return;
+        grain = std::max<size_t>(grain, 1);
+        if (workers.empty() || count <= grain)
+        {
+            fn(0u, (size_t)0, count);
+            return;
+        }
+        std::atomic<size_t> next(0);
+        std::function<void(unsigned)> body = [&](unsigned worker)
+        {
+            while (true)
+            {
+                size_t begin = next.fetch_add(grain);
+                if (begin >= count)
+                    break;
+                fn(worker, begin, std::min(count, begin + grain));
+            }
+        };
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &body;
+            busy = (unsigned)workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        body(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]
+                  { return busy == 0; });
+        job = nullptr;
+    }
+
+private:
+    /// @brief waits for a new loop, works on it and reports when it is finished
+    void worker_loop(unsigned id)
+    {
+        unsigned long long seen = 0;
+        while (true)
+        {
+            std::function<void(unsigned)> *body;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]
+                          { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+                body = job;
+            }
+            (*body)(id);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--busy == 0)
+                    done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void(unsigned)> *job = nullptr;
+    unsigned busy = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+/// @file tiny_hull.h
+/// @brief hulls of at most 16 points with one kernel per size, picked by template dispatch
+///
+/// the kernel for n points copies them to the stack, sorts them by x with the networks of small_sort.h and runs the monotone
+/// chain of sorted_hull.h on them; n is a template parameter, so every loop has a constant bound and is unrolled, and nothing is
+/// allocated; compute_hull(automatic) takes them for small sets, ks_find_hull() ends its recursion the same way
+
+#include <algorithm>
+#include <utility>
+#include "hull_point.h"
+#include "small_sort.h"
+#include "sorted_hull.h"
+
+/// @brief largest input the tiny kernels take
+const int hull_tiny_limit = 16;
+
+/// @brief the points sorted by x, on the stack
+template <int N, class P>
+struct tiny_sorted
+{
+    P pts[N > 0 ? N : 1];
+
+    explicit tiny_sorted(const P *in)
+    {
+        std::copy(in, in + N, pts);
+        hull_small_sort(pts, N, [](const P &a, const P &b)
+                        { return a.x < b.x; });
+    }
+};
+
+/// @brief hull of exactly N points, same hull and order as ks_hull()
+/// @param out receives the hull, it needs room for N points
+/// @return number of points in the hull
+template <int N, class P>
+inline int tiny_hull_n(const P *pts, P *out)
+{
+    tiny_sorted<N, P> sorted(pts);
+    int ids[2 * N > 0 ? 2 * N : 1];
+    int h = sorted_hull_ids(sorted.pts, N, [](int k)
+                            { return k; }, ids);
+    for (int i = 0; i < h; i++)
+        out[i] = sorted.pts[ids[i]];
+    return h;
+}
+
+/// @brief hull of exactly N points as indices into pts, same hull and order as ks_hull_indices()
+/// @param out receives the indices of the hull points, it needs room for N of them
+/// @return number of points in the hull
+template <int N, class P>
+inline int tiny_hull_indices_n(const P *pts, int *out)
+{
+    int order[N > 0 ? N : 1];
+    for (int i = 0; i < N; i++)
+        order[i] = i;
+    hull_small_sort(order, N, [pts](int a, int b)
+                    { return pts[a].x < pts[b].x; });
+    int ids[2 * N > 0 ? 2 * N : 1];
+    int h = sorted_hull_ids(pts, N, [&order](int k)
+                            { return order[k]; }, ids);
+    std::copy(ids, ids + h, out);
+    return h;
+}
+
+/// @brief the kernels of every size up to hull_tiny_limit, indexed by the size
+template <class P, int... N>
+inline int tiny_hull_dispatch(const P *pts, int n, P *out, std::integer_sequence<int, N...>)
+{
+    typedef int (*kernel)(const P *, P *);
+    static const kernel kernels[] = {&tiny_hull_n<N, P>...};
+    return kernels[n](pts, out);
+}
+
+template <class P, int... N>
+inline int tiny_hull_indices_dispatch(const P *pts, int n, int *out, std::integer_sequence<int, N...>)
+{
+    typedef int (*kernel)(const P *, int *);
+    static const kernel kernels[] = {&tiny_hull_indices_n<N, P>...};
+    return kernels[n](pts, out);
+}
+
+/// @brief hull of at most hull_tiny_limit points with the kernel of their number
+/// @param out receives the hull, it needs room for n points
+/// @return number of points in the hull
+template <class P>
+inline int tiny_hull(const P *pts, int n, P *out)
+{
+    if (n <= 0)
+        return 0;
+    return tiny_hull_dispatch(pts, n, out, std::make_integer_sequence<int, hull_tiny_limit + 1>());
+}
+
+/// @brief hull of at most hull_tiny_limit points as indices into pts
+/// @param out receives the indices of the hull points, it needs room for n of them
+/// @return number of points in the hull
+template <class P>
+inline int tiny_hull_indices(const P *pts, int n, int *out)
+{
+    if (n <= 0)
+        return 0;
+    return tiny_hull_indices_dispatch(pts, n, out, std::make_integer_sequence<int, hull_tiny_limit + 1>());
+}
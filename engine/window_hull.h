@@ -0,0 +1,253 @@
+#pragma once
+
+/// @file window_hull.h
+/// @brief convex hull of the last points of a stream (the last N points or the points of the last W seconds)
+///
+/// the points are kept in blocks of a fixed size B, and every full block stores its points sorted by x and its hull
+/// the blocks work like a queue made of two stacks:
+/// the back stack keeps the hull of all its full blocks, the front stack keeps for every block the hull of that block and of all
+/// the blocks behind it in the front stack (the suffix hulls), computed all at once when the front stack runs empty
+/// hulls are only ever merged with hull_union(), which is linear in their sizes, nothing is hulled again from scratch
+///
+/// costs, with h the size of the hulls: a point costs O(log B) amortized (the sort of its block) plus O(h / B) for the merges;
+/// hull() merges the two stack hulls (cached until a block fills or leaves), the points pushed since the last call (sorted) and
+/// the rest of the oldest block, which it scans again in x order after a pop: O(h + k log k) after k pushes, O(h + B) after pops
+/// so this is not the O(log h) per point of a fully dynamic hull, a window which is read after every pop pays O(B) per read
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "hull_point.h"
+#include "hull_merge.h"
+#include "sorted_hull.h"
+
+/// @brief keeps the points of a sliding window and gives their hull at any moment
+template <class P = Vector2>
+class window_hull
+{
+public:
+    /// @param max_points keep at most this many points, push() drops the oldest ones (0 means no limit, use expire_before())
+    /// @param block_points points per block, a few times the expected hull size is a good value
+    explicit window_hull(size_t max_points = 0, size_t block_points = 256)
+        : max_points(max_points), block_size(block_points ? block_points : 1)
+    {
+    }
+
+    /// @brief adds a point at the back of the window
+    /// @param time timestamp of the point, only used by expire_before() (it must not go down)
+    void push(P p, double time = 0)
+    {
+        if (blocks.empty() || blocks.back().points.size() == block_size)
+        {
+            blocks.emplace_back();
+            blocks.back().points.reserve(block_size);
+            blocks.back().times.reserve(block_size);
+            newest.clear();
+            newest_done = 0;
+        }
+        block &b = blocks.back();
+        b.points.push_back(p);
+        b.times.push_back(time);
+        count++;
+        dirty = true;
+        if (b.points.size() == block_size)
+        {
+            /// a full block goes into the hull of the back stack
+            sort_block(b);
+            hull_of(b, b.hull);
+            merge_into(back_hull, b.hull, back_hull);
+            stacks_dirty = true;
+        }
+        if (max_points && count > max_points)
+            pop_front();
+    }
+
+    /// @brief drops the oldest point of the window
+    void pop_front()
+    {
+        if (count == 0)
+            return;
+        if (front_blocks == 0 && blocks.front().points.size() == block_size)
+            flip();
+        block &b = blocks.front();
+        b.head++;
+        count--;
+        dirty = true;
+        oldest_dirty = true;
+        if (b.head == b.points.size())
+        {
+            blocks.pop_front();
+            if (front_blocks > 0)
+            {
+                front_blocks--;
+                stacks_dirty = true;
+            }
+        }
+    }
+
+    /// @brief drops the points with a timestamp older than time
+    void expire_before(double time)
+    {
+        while (count > 0 && blocks.front().times[blocks.front().head] < time)
+            pop_front();
+    }
+
+    /// @brief number of points in the window
+    size_t size() const { return count; }
+
+    /// @brief the hull of the points in the window, in the order ks_hull() gives
+    const std::vector<P> &hull()
+    {
+        if (!dirty)
+            return current;
+        if (stacks_dirty)
+        {
+            /// the front stack without its oldest block (which lost points since its suffix was made) and the back stack
+            if (front_blocks > 1)
+                merge_into(blocks[1].suffix, back_hull, stacks);
+            else
+                stacks = back_hull;
+            stacks_dirty = false;
+        }
+        current = stacks;
+        if (front_blocks > 0)
+        {
+            if (oldest_dirty)
+                hull_of(blocks.front(), oldest);
+            oldest_dirty = false;
+            merge_into(current, oldest, current);
+        }
+        if (!blocks.empty() && blocks.back().points.size() < block_size)
+        {
+            update_newest();
+            merge_into(current, newest, current);
+        }
+        dirty = false;
+        return current;
+    }
+
+private:
+    struct block
+    {
+        std::vector<P> points;
+        std::vector<double> times;
+        /// @brief index of the oldest point still in the window
+        size_t head = 0;
+        /// @brief indices of the points sorted by x, made when the block fills
+        std::vector<int> order;
+        /// @brief hull of the points from head, computed when the block fills
+        std::vector<P> hull;
+        /// @brief hull of this block and of the blocks behind it in the front stack
+        std::vector<P> suffix;
+    };
+
+    static void sort_block(block &b)
+    {
+        b.order.resize(b.points.size());
+        for (size_t i = 0; i < b.order.size(); i++)
+            b.order[i] = (int)i;
+        const std::vector<P> &pts = b.points;
+        std::sort(b.order.begin(), b.order.end(), [&pts](int i, int j)
+                  { return pts[i].x < pts[j].x; });
+    }
+
+    /// @brief hull of the points of a full block still in the window, one scan of its sorted order
+    void hull_of(const block &b, std::vector<P> &out)
+    {
+        live.clear();
+        for (int i : b.order)
+        {
+            if ((size_t)i >= b.head)
+                live.push_back(i);
+        }
+        hull_sorted(b.points.data(), out);
+    }
+
+    /// @brief hull of the points at the indices in live, which are sorted by x
+    void hull_sorted(const P *pts, std::vector<P> &out)
+    {
+        int n = (int)live.size();
+        ids.resize(2 * (size_t)n);
+        const std::vector<int> &at = live;
+        int h = sorted_hull_ids(pts, n, [&at](int k)
+                                { return at[k]; }, ids.data());
+        out.resize(h);
+        for (int i = 0; i < h; i++)
+            out[i] = pts[ids[i]];
+    }
+
+    /// @brief brings the hull of the newest block (not full) up to date with the points pushed since the last call
+    void update_newest()
+    {
+        const block &b = blocks.back();
+        if (b.head > 0)
+        {
+            /// the newest block is also the oldest one and lost points, its hull is made again
+            newest.clear();
+            newest_done = b.head;
+        }
+        if (newest_done == b.points.size())
+            return;
+        live.clear();
+        for (size_t i = newest_done; i < b.points.size(); i++)
+            live.push_back((int)i);
+        const std::vector<P> &pts = b.points;
+        std::sort(live.begin(), live.end(), [&pts](int i, int j)
+                  { return pts[i].x < pts[j].x; });
+        hull_sorted(b.points.data(), fresh);
+        merge_into(newest, fresh, newest);
+        newest_done = b.points.size();
+    }
+
+    /// @brief out = hull of a and b (out may be a or b)
+    void merge_into(const std::vector<P> &a, const std::vector<P> &b, std::vector<P> &out)
+    {
+        merged.resize(a.size() + b.size());
+        merged.resize(hull_union(a.data(), (int)a.size(), b.data(), (int)b.size(), merged.data(), union_ws));
+        out.swap(merged);
+    }
+
+    /// @brief moves every full block to the front stack and computes their suffix hulls, from the newest to the oldest
+    void flip()
+    {
+        size_t full = blocks.size();
+        if (blocks.back().points.size() < block_size)
+            full--;
+        for (size_t i = full; i-- > 0;)
+        {
+            if (i + 1 == full)
+                blocks[i].suffix = blocks[i].hull;
+            else
+                merge_into(blocks[i].hull, blocks[i + 1].suffix, blocks[i].suffix);
+            /// the block hulls are not needed anymore once they are in the suffixes
+            std::vector<P>().swap(blocks[i].hull);
+        }
+        front_blocks = full;
+        back_hull.clear();
+        stacks_dirty = true;
+    }
+
+    size_t max_points;
+    size_t block_size;
+    size_t count = 0;
+    /// @brief the first front_blocks blocks are the front stack, the others the back stack
+    size_t front_blocks = 0;
+    std::deque<block> blocks;
+    /// @brief hull of the full blocks of the back stack
+    std::vector<P> back_hull;
+    /// @brief hull of the two stacks without the oldest block, made again when a block fills or leaves
+    std::vector<P> stacks;
+    bool stacks_dirty = false;
+    /// @brief hull of what is left of the oldest block of the front stack, made again after a pop
+    std::vector<P> oldest;
+    bool oldest_dirty = true;
+    /// @brief hull of the points of the newest block (not full) up to newest_done
+    std::vector<P> newest;
+    size_t newest_done = 0;
+    std::vector<P> current;
+    bool dirty = false;
+    std::vector<int> live, ids;
+    std::vector<P> fresh, merged;
+    hull_union_workspace<P> union_ws;
+};
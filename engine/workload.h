@@ -0,0 +1,178 @@
+#pragma once
+
+/// @file workload.h
+/// @brief seeded generator of test inputs for the visualizers, the benchmarks and the tools
+///
+/// point i only depends on the seed and on i (counter based random numbers), so the output is the same for any number of
+/// threads, and the loop over the points has no dependency between iterations so it can be split between threads and vectorized
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "hull_point.h"
+#include "thread_pool.h"
+
+/// @brief the distributions the generator knows
+enum class workload_kind
+{
+    /// @brief uniform in the rectangle
+    uniform_square,
+    /// @brief uniform in the disk inscribed in the rectangle
+    disk,
+    /// @brief on the circle inscribed in the rectangle, every point is on the hull
+    circle,
+    /// @brief gaussian clusters around random centers
+    gaussian_clusters,
+    /// @brief close to the diagonal of the rectangle
+    near_collinear,
+    /// @brief only a few distinct points, each repeated many times
+    duplicate_heavy,
+};
+
+/// @brief what to generate
+struct workload
+{
+    workload_kind kind = workload_kind::uniform_square;
+    /// @brief number of points
+    size_t n = 0;
+    /// @brief same seed (and same parameters) gives the same points
+    uint64_t seed = 1;
+    /// @brief the rectangle the points are generated in
+    float x = 0, y = 0, width = 10000, height = 10000;
+    /// @brief number of clusters for gaussian_clusters
+    int clusters = 8;
+    /// @brief standard deviation of a cluster, as a fraction of the rectangle size
+    float spread = 0.02f;
+    /// @brief distance from the diagonal for near_collinear, as a fraction of the rectangle size
+    float jitter = 1e-4f;
+    /// @brief number of distinct points for duplicate_heavy (0 means n/100), they are picked like the cluster centers
+    size_t distinct = 0;
+};
+
+/// @brief mixes a 64 bit value (splitmix64), used as a counter based random generator
+inline uint64_t workload_mix(uint64_t z)
+{
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/// @brief the k-th random number of point i, uniform in [0,1)
+inline double workload_uniform(uint64_t seed, uint64_t i, uint64_t k)
+{
+    return (workload_mix(seed ^ workload_mix(i * 4 + k)) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/// @brief point i of the workload
+inline Vector2 workload_point(const workload &w, uint64_t i)
+{
+    const double two_pi = 6.283185307179586;
+    double cx = w.x + w.width / 2.0, cy = w.y + w.height / 2.0;
+    double rx = w.width / 2.0, ry = w.height / 2.0;
+    double u1 = workload_uniform(w.seed, i, 0);
+    double u2 = workload_uniform(w.seed, i, 1);
+    double px, py;
+    switch (w.kind)
+    {
+    case workload_kind::disk:
+    {
+        double r = std::sqrt(u1), a = two_pi * u2;
+        px = cx + rx * r * std::cos(a);
+        py = cy + ry * r * std::sin(a);
+        break;
+    }
+    case workload_kind::circle:
+    {
+        double a = two_pi * u1;
+        px = cx + rx * std::cos(a);
+        py = cy + ry * std::sin(a);
+        break;
+    }
+    case workload_kind::gaussian_clusters:
+    {
+        /// the cluster centers come from the same generator, with indices counted down from the top so they never meet the points
+        uint64_t c = (uint64_t)(workload_uniform(w.seed, i, 2) * (w.clusters > 0 ? w.clusters : 1));
+        double ccx = w.x + w.width * (0.1 + 0.8 * workload_uniform(w.seed, ~c, 0));
+        double ccy = w.y + w.height * (0.1 + 0.8 * workload_uniform(w.seed, ~c, 1));
+        /// Box-Muller
+        double r = std::sqrt(-2.0 * std::log(1.0 - u1)), a = two_pi * u2;
+        px = ccx + w.spread * w.width * r * std::cos(a);
+        py = ccy + w.spread * w.height * r * std::sin(a);
+        break;
+    }
+    case workload_kind::near_collinear:
+    {
+        double d = (u2 - 0.5) * w.jitter;
+        px = w.x + w.width * (u1 + d);
+        py = w.y + w.height * (u1 - d);
+        break;
+    }
+    case workload_kind::duplicate_heavy:
+    {
+        uint64_t distinct = w.distinct ? w.distinct : (w.n / 100 ? w.n / 100 : 1);
+        uint64_t j = (uint64_t)(u1 * distinct);
+        px = w.x + w.width * workload_uniform(w.seed, ~j, 0);
+        py = w.y + w.height * workload_uniform(w.seed, ~j, 1);
+        break;
+    }
+    default:
+        px = w.x + w.width * u1;
+        py = w.y + w.height * u2;
+        break;
+    }
+    /// keep the points inside the rectangle (the gaussian tails and the rounding to float can leave it)
+    px = std::fmin(std::fmax(px, (double)w.x), (double)w.x + w.width);
+    py = std::fmin(std::fmax(py, (double)w.y), (double)w.y + w.height);
+    Vector2 p;
+    p.x = (float)px;
+    p.y = (float)py;
+    return p;
+}
+
+/// @brief writes the points of the workload to out (w.n points)
+/// @param pool generates in parallel on this pool when given, the points are the same either way
+inline void generate_points(const workload &w, Vector2 *out, hull_thread_pool *pool = nullptr)
+{
+    auto fill = [&](unsigned, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            out[i] = workload_point(w, i);
+    };
+    if (pool)
+        pool->parallel_for(w.n, 1 << 16, fill);
+    else
+        fill(0, 0, w.n);
+}
+
+/// @brief generates the points of the workload
+inline std::vector<Vector2> generate_points(const workload &w, hull_thread_pool *pool = nullptr)
+{
+    std::vector<Vector2> points(w.n);
+    generate_points(w, points.data(), pool);
+    return points;
+}
+
+/// @brief names of the distributions, in the order of workload_kind
+inline const char *workload_name(workload_kind kind)
+{
+    static const char *names[] = {"uniform", "disk", "circle", "clusters", "collinear", "duplicates"};
+    return names[(int)kind];
+}
+
+/// @brief finds a distribution by its name (see workload_name())
+/// @return false if there is no distribution with that name
+inline bool workload_from_name(const char *name, workload_kind &kind)
+{
+    for (int i = 0; i <= (int)workload_kind::duplicate_heavy; i++)
+    {
+        if (std::strcmp(name, workload_name((workload_kind)i)) == 0)
+        {
+            kind = (workload_kind)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,369 @@
+/// @file hull_bench.cpp
+/// @brief headless benchmark of the hull engines
+///
+/// prints one line per case: name, number of points and the best time of a few runs in milliseconds
+/// the same program is built natively and to wasm (scalar and simd128 + pthreads), see the Makefile and wasm_bench.js
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../engine/hull.h"
+#include "../engine/approx_hull.h"
+#include "../engine/column_reduce.h"
+#include "../engine/hull_batch.h"
+#include "../engine/dc_hull.h"
+#include "../engine/convex_layers.h"
+#include "../engine/hull_cache.h"
+#include "../engine/hull_calipers.h"
+#include "../engine/hull_query.h"
+#include "../engine/hull_simd.h"
+#include "../engine/kinetic_hull.h"
+#include "../engine/quick_hull.h"
+#include "../engine/window_hull.h"
+#include "../engine/workload.h"
+
+using namespace std;
+
+/// @brief runs fn a few times and returns the best time in milliseconds
+template <class F>
+double bench_time(int runs, F fn)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; r++)
+    {
+        auto start = chrono::steady_clock::now();
+        fn();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        best = min(best, ms);
+    }
+    return best;
+}
+
+/// @brief n points of the given distribution in a 10000x10000 square
+vector<Vector2> make_points(workload_kind kind, int n, unsigned seed)
+{
+    workload w;
+    w.kind = kind;
+    w.n = n;
+    w.seed = seed;
+    return generate_points(w);
+}
+
+/// @brief time of one engine on many sets of n points, per set in microseconds
+double per_set_time(hull_engine engine, const vector<Vector2> &points, int n)
+{
+    ks_workspace ws;
+    vector<Vector2> out(n);
+    int sets = (int)points.size() / n;
+    return bench_time(3, [&]
+                      {
+        for (int i = 0; i < sets; i++)
+            compute_hull(engine, points.data() + (size_t)i * n, n, out.data(), ws); }) *
+           1000 / sets;
+}
+
+/// @brief smallest set size where Kirkpatrick-Seidel (with the given bridge finder) beats the jarvis march
+///
+/// it prints the sizes it tried, the crossover is the first one where the ratio jarvis / KS goes over 1
+/// the sweep starts above ks_leaf_size, below it KS does not recurse and only the monotone chain of the leaf would be measured
+int find_crossover(workload_kind kind, hull_engine ks, int total)
+{
+    int crossover = -1;
+    for (int n = 2 * ks_leaf_size; n <= 16384; n *= 2)
+    {
+        vector<Vector2> points = make_points(kind, max(total / n, 1) * n, 4);
+        double jarvis = per_set_time(hull_engine::jarvis, points, n);
+        double other = per_set_time(ks, points, n);
+        printf("# %s n=%d jarvis %.2fus ks %.2fus\n", workload_name(kind), n, jarvis, other);
+        if (other < jarvis)
+        {
+            crossover = n;
+            break;
+        }
+    }
+    return crossover;
+}
+
+/// @brief prints one result line
+void report(const char *name, long long n, double ms)
+{
+    printf("%-24s %10lld %12.3f\n", name, n, ms);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    /// "quick" runs smaller inputs, used when the wasm builds run under node
+    bool quick = argc > 1 && strcmp(argv[1], "quick") == 0;
+    int big = quick ? 200000 : 1000000;
+    hull_batch<> batch;
+    hull_thread_pool batch_pool;
+    printf("# simd=%s threads=%u\n", hull_simd_name(), batch.threads());
+
+    {
+        hull_thread_pool pool;
+        workload w;
+        w.kind = workload_kind::gaussian_clusters;
+        w.n = big;
+        vector<Vector2> points(big);
+        report("generate", big, bench_time(3, [&]
+                                           { generate_points(w, points.data(), &pool); }));
+    }
+    {
+        vector<Vector2> points = make_points(workload_kind::uniform_square, big, 1);
+        vector<Vector2> out(points.size());
+        Vector2 l = {0, 5000}, r = {10000, 5000};
+        report("filter", big, bench_time(5, [&]
+                                         { hull_select_side(points.data(), big, l, r, 1, false, out.data()); }));
+    }
+    for (int n : {10000, 100000, big})
+    {
+        vector<Vector2> points = make_points(workload_kind::uniform_square, n, 2);
+        vector<Vector2> out(points.size());
+        ks_workspace ws;
+        report("kirkpatrick_seidel", n, bench_time(3, [&]
+                                                   { ks_hull(points.data(), n, out.data(), ws); }));
+        ws.finder = ks_bridge_finder::randomized;
+        report("ks_randomized", n, bench_time(3, [&]
+                                              { ks_hull(points.data(), n, out.data(), ws); }));
+        report("jarvis", n, bench_time(3, [&]
+                                       { jarvis_hull(points.data(), n, out.data()); }));
+        report("quickhull", n, bench_time(3, [&]
+                                          { compute_hull(hull_engine::quickhull, points.data(), n, out.data(), ws); }));
+        vector<int> ids(points.size());
+        ks_index_workspace_of<Vector2> ws_ids;
+        report("ks_indices", n, bench_time(3, [&]
+                                           { ks_hull_indices(points.data(), n, ids.data(), ws_ids); }));
+    }
+    {
+        /// uniform points on a 2^30 grid, as int32 and as double (compare with kirkpatrick_seidel above for floats)
+        vector<hull_point_i32> ints(big), int_out(big);
+        vector<hull_point_f64> doubles(big), double_out(big);
+        for (int i = 0; i < big; i++)
+        {
+            ints[i].x = (int32_t)(workload_uniform(2, i, 0) * (1 << 30));
+            ints[i].y = (int32_t)(workload_uniform(2, i, 1) * (1 << 30));
+            doubles[i] = {(double)ints[i].x, (double)ints[i].y};
+        }
+        ks_workspace_of<hull_point_i32> ws_i32;
+        ks_workspace_of<hull_point_f64> ws_f64;
+        report("ks_int32", big, bench_time(3, [&]
+                                           { ks_hull(ints.data(), big, int_out.data(), ws_i32); }));
+        report("ks_double", big, bench_time(3, [&]
+                                            { ks_hull(doubles.data(), big, double_out.data(), ws_f64); }));
+    }
+    {
+        vector<Vector2> points = make_points(workload_kind::uniform_square, big, 2);
+        vector<Vector2> out(points.size());
+        dc_hull<> dc;
+        report("divide_conquer", big, bench_time(3, [&]
+                                                 { dc.run(points.data(), big, out.data()); }));
+        vector<int> ids(points.size());
+        report("dc_indices", big, bench_time(3, [&]
+                                             { dc.run_indices(points.data(), big, ids.data()); }));
+    }
+    for (workload_kind kind : {workload_kind::uniform_square, workload_kind::gaussian_clusters, workload_kind::disk})
+    {
+        /// Quickhull against KS on the calling thread and on the pool, clusters are the skewed input with few hull points
+        vector<Vector2> points = make_points(kind, big, 2);
+        vector<Vector2> out(points.size());
+        ks_workspace ws;
+        quick_hull<> quick;
+        string suffix = string("_") + workload_name(kind);
+        report(("ks" + suffix).c_str(), big, bench_time(3, [&]
+                                                        { ks_hull(points.data(), big, out.data(), ws); }));
+        report(("quickhull" + suffix).c_str(), big, bench_time(3, [&]
+                                                               { compute_hull(hull_engine::quickhull, points.data(), big, out.data(), ws); }));
+        report(("quickhull_pool" + suffix).c_str(), big, bench_time(3, [&]
+                                                                    { quick.run(points.data(), big, out.data()); }));
+    }
+    {
+        /// regression check: points on y = x/2 moved by one ulp, with x in [0, 10000], and the vertex (3741.92, 1870.96); the
+        /// heights of the points above a chord are so close that rounding them picked the wrong farthest point, so Quickhull
+        /// (alone and on the pool) must give the same hull as KS and jarvis, the bench fails otherwise
+        quick_hull<> quick;
+        int bad = 0;
+        for (int seed = 1; seed <= 100; seed++)
+        {
+            vector<Vector2> points;
+            for (int i = 0; i < 2000; i++)
+            {
+                float x = (float)(workload_uniform(seed, i, 0) * 10000), y = x / 2;
+                double v = workload_uniform(seed, i, 1);
+                if (v < 1.0 / 3)
+                    y = nextafter(y, 0.0f);
+                else if (v < 2.0 / 3)
+                    y = nextafter(y, 10000.0f);
+                points.push_back({x, y});
+            }
+            points.push_back({3741.92f, 1870.96f});
+            vector<Vector2> ks = compute_hull(hull_engine::kirkpatrick_seidel, points);
+            vector<Vector2> pooled(points.size());
+            pooled.resize(quick.run(points.data(), (int)points.size(), pooled.data()));
+            auto same = [&ks](const vector<Vector2> &h)
+            {
+                return h.size() == ks.size() && equal(h.begin(), h.end(), ks.begin(), [](const Vector2 &a, const Vector2 &b)
+                                                      { return a.x == b.x && a.y == b.y; });
+            };
+            if (!same(compute_hull(hull_engine::jarvis, points)) || !same(compute_hull(hull_engine::quickhull, points)) || !same(pooled))
+                bad++;
+        }
+        if (bad > 0)
+        {
+            fprintf(stderr, "quickhull_near_collinear: %d of 100 sets give a different hull than ks and jarvis\n", bad);
+            return 1;
+        }
+        printf("# quickhull_near_collinear: 100 sets, same hull as ks and jarvis\n");
+    }
+    {
+        /// the same points sorted by x, and with one point in a hundred swapped with a neighbour
+        vector<Vector2> points = make_points(workload_kind::uniform_square, big, 2);
+        sort(points.begin(), points.end(), [](const Vector2 &a, const Vector2 &b)
+             { return a.x < b.x; });
+        vector<Vector2> out(points.size());
+        ks_workspace ws;
+        report("ks_sorted_input", big, bench_time(3, [&]
+                                                  { ks_hull(points.data(), big, out.data(), ws); }));
+        report("automatic_sorted", big, bench_time(3, [&]
+                                                   { compute_hull(hull_engine::automatic, points.data(), big, out.data(), ws); }));
+        for (int i = 0; i + 1 < big; i += 100)
+            swap(points[i], points[i + 1]);
+        report("automatic_nearly_sorted", big, bench_time(3, [&]
+                                                          { compute_hull(hull_engine::automatic, points.data(), big, out.data(), ws); }));
+    }
+    {
+        /// the column extremes and the repair scan in front of KS, with the share of the points they keep
+        vector<Vector2> points = make_points(workload_kind::uniform_square, big, 2);
+        vector<Vector2> out(points.size());
+        column_reduce_workspace_of<Vector2> ws;
+        column_reduce_stats stats;
+        report("column_reduced_ks", big, bench_time(3, [&]
+                                                    { column_reduced_hull(hull_engine::kirkpatrick_seidel, points.data(), big, out.data(), ws, 0, &stats); }));
+        printf("# column_reduce: %d columns, %d extremes, %d repaired, ratio %.4f\n", stats.columns, stats.extremes, stats.repaired, stats.ratio());
+    }
+    {
+        /// every point moves by up to half a unit per frame, the hull is recomputed after every move
+        vector<Vector2> points = make_points(workload_kind::uniform_square, big, 2);
+        vector<Vector2> out(points.size());
+        kinetic_hull<> kinetic;
+        ks_workspace ws;
+        int frame = 0;
+        auto move = [&]
+        {
+            frame++;
+            for (int i = 0; i < big; i++)
+            {
+                points[i].x += (float)(workload_uniform(frame, i, 0) - 0.5);
+                points[i].y += (float)(workload_uniform(frame, i, 1) - 0.5);
+            }
+        };
+        kinetic.update(points.data(), big, out.data());
+        report("ks_moving_frame", big, bench_time(3, [&]
+                                                  { move(); ks_hull(points.data(), big, out.data(), ws); }));
+        report("kinetic_moving_frame", big, bench_time(3, [&]
+                                                       { move(); kinetic.update(points.data(), big, out.data()); }));
+    }
+    for (int size : {8, 16})
+    {
+        /// many tiny sets, automatic runs the kernels of tiny_hull.h on them
+        vector<Vector2> points = make_points(workload_kind::uniform_square, big / size * size, 4);
+        char name[32];
+        snprintf(name, sizeof(name), "tiny_sets_of_%d", size);
+        report(name, (long long)points.size(), per_set_time(hull_engine::automatic, points, size) * (points.size() / size) / 1000);
+        snprintf(name, sizeof(name), "jarvis_sets_of_%d", size);
+        report(name, (long long)points.size(), per_set_time(hull_engine::jarvis, points, size) * (points.size() / size) / 1000);
+    }
+    {
+        int sets = quick ? 2000 : 10000, size = 100;
+        vector<Vector2> points = make_points(workload_kind::uniform_square, sets * size, 3);
+        vector<size_t> offsets;
+        for (int i = 0; i <= sets; i++)
+            offsets.push_back((size_t)i * size);
+        vector<Vector2> out;
+        vector<int> counts;
+        report("batch_100", (long long)sets * size, bench_time(3, [&]
+                                                             { batch.run(points, offsets, out, counts); }));
+        vector<hull_measures> measures(sets);
+        report("calipers_100", (long long)sets * size, bench_time(3, [&]
+                                                                { measure_hulls(out.data(), offsets.data(), counts.data(), sets, measures.data(), &batch_pool); }));
+    }
+    {
+        /// a repeated query: the fingerprint and the lookup replace the whole hull
+        vector<Vector2> points = make_points(workload_kind::uniform_square, big, 2);
+        vector<Vector2> hull;
+        hull_cache<> cache;
+        ks_workspace ws;
+        auto compute = [&](const Vector2 *pts, size_t n, vector<Vector2> &out)
+        {
+            out.resize(n);
+            out.resize(ks_hull(pts, (int)n, out.data(), ws));
+        };
+        cache.get(points.data(), big, hull, compute);
+        report("cache_hit", big, bench_time(3, [&]
+                                            { cache.get(points.data(), big, hull, compute); }));
+    }
+    {
+        /// classify a million points against the hull of 10000 points on a circle and against the small hull of a uniform square
+        vector<Vector2> queries = make_points(workload_kind::uniform_square, big, 6);
+        vector<uint8_t> where(big);
+        for (workload_kind kind : {workload_kind::circle, workload_kind::uniform_square})
+        {
+            vector<Vector2> points = make_points(kind, 10000, 7);
+            vector<Vector2> hull(points.size());
+            ks_workspace ws;
+            hull.resize(ks_hull(points.data(), (int)points.size(), hull.data(), ws));
+            hull_query<> query(hull);
+            report(kind == workload_kind::circle ? "locate_circle_hull" : "locate_small_hull", big, bench_time(3, [&]
+                                                                                                    { query.locate(queries.data(), big, where.data(), &batch_pool); }));
+        }
+    }
+    for (workload_kind kind : {workload_kind::uniform_square, workload_kind::circle})
+    {
+        /// the approximate hull with 64 directions, the error is printed relative to the extent of the input (10000)
+        vector<Vector2> points = make_points(kind, big, 2);
+        vector<Vector2> out;
+        approx_hull<> approx(64);
+        double error = 0;
+        report(kind == workload_kind::circle ? "approx_64_circle" : "approx_64_uniform", big, bench_time(3, [&]
+                                                                                               { error = approx.run(points.data(), big, out); }));
+        printf("# approx_64 %s: %zu points, error %.4f\n", workload_name(kind), out.size(), error);
+    }
+    {
+        /// onion peeling of a uniform square (about n^(2/3) layers)
+        int n = quick ? 10000 : 100000;
+        vector<Vector2> points = make_points(workload_kind::uniform_square, n, 8);
+        vector<int> depth(n);
+        int layers = 0;
+        report("convex_layers", n, bench_time(1, [&]
+                                              { layers = convex_layers(points.data(), n, depth.data()); }));
+        printf("# convex_layers: %d layers\n", layers);
+    }
+    {
+        /// sliding window of the last 10000 points, with the hull read after every 100 points
+        vector<Vector2> points = make_points(workload_kind::gaussian_clusters, big, 5);
+        report("window_10000", big, bench_time(3, [&]
+                                               {
+            window_hull<> window(10000);
+            for (int i = 0; i < big; i++)
+            {
+                window.push(points[i], i);
+                if (i % 100 == 0)
+                    window.hull();
+            } }));
+    }
+
+    /// where KS starts to beat jarvis, for both bridge finders (the smaller, the more the randomized finder helps)
+    int total = quick ? 20000 : 100000;
+    for (workload_kind kind : {workload_kind::uniform_square, workload_kind::circle})
+    {
+        int det = find_crossover(kind, hull_engine::kirkpatrick_seidel, total);
+        int rnd = find_crossover(kind, hull_engine::kirkpatrick_seidel_randomized, total);
+        printf("# crossover %s: median of medians n=%d, randomized n=%d\n", workload_name(kind), det, rnd);
+    }
+    return 0;
+}
@@ -0,0 +1,561 @@
+/// @file hull_cli.cpp
+/// @brief hulls of a stream of point sets, with reading, parsing, hulling and writing as concurrent pipeline stages
+///
+/// usage:
+///   hull_cli [options] [input]                                    hulls every set of the input (stdin if none or "-")
+///   hull_cli --generate <file> <sets> <points> [distribution] [seed]  writes a batch file of generated sets
+///
+/// options:
+///   --text / --binary   input format, by default files ending with .txt and stdin are text, anything else binary
+///   --out <file>        output file instead of stdout
+///   --binary-out        write binary records instead of text
+///   --indices           write the index of every hull point in its set instead of its coordinates
+///   --parsers <n>       parse threads (default: a quarter of the hardware threads, at least 1)
+///   --workers <n>       hull threads (default: one per hardware thread)
+///   --queue <n>         capacity of every queue between two stages, in blocks (default 8)
+///   --block <bytes>     size of the blocks the input is read in (default 4 MB)
+///
+/// text input has one "x y" per line and the sets are separated by blank lines, binary input is a sequence of records made of
+/// a little endian uint32 count and that many float32 x y pairs; the output has the same layout (the indices as uint32 in binary)
+/// with one hull per input set, in the input order and in the engine order; an incomplete record at the end of binary input is
+/// reported on stderr and makes the exit status 1
+///
+/// the stages are: read (one thread, cuts the input into blocks of whole sets), parse (blocks to points), hull and write (one
+/// thread, puts the hulls back in input order and serializes them); the stages are joined by bounded queues and the hulls wait
+/// for their turn in a bounded window, so a slow stage or a slow set holds the others back instead of letting memory grow, and
+/// the throughput of every stage is printed on stderr at the end
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../engine/hull.h"
+#include "../engine/workload.h"
+
+using namespace std;
+
+typedef chrono::steady_clock timer;
+
+/// @brief blocking queue with a fixed capacity between two stages, any number of threads can push and pop
+template <class T>
+class bounded_queue
+{
+public:
+    /// @param producers number of threads which push, the queue is closed when all of them called done()
+    bounded_queue(size_t capacity, int producers) : capacity(capacity ? capacity : 1), producers(producers) {}
+
+    /// @brief waits for room and adds the item
+    void push(T item)
+    {
+        unique_lock<mutex> lock(m);
+        not_full.wait(lock, [&]
+                      { return items.size() < capacity; });
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+    }
+
+    /// @brief waits for an item
+    /// @return false once every producer is done and the queue is empty
+    bool pop(T &item)
+    {
+        unique_lock<mutex> lock(m);
+        not_empty.wait(lock, [&]
+                       { return !items.empty() || producers == 0; });
+        if (items.empty())
+            return false;
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    /// @brief called by every producer when it has pushed its last item
+    void done()
+    {
+        lock_guard<mutex> lock(m);
+        if (--producers == 0)
+            not_empty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    int producers;
+    deque<T> items;
+    mutex m;
+    condition_variable not_full, not_empty;
+};
+
+/// @brief holds back the batches which are too far ahead of the writer, so the batches waiting to be put in order are bounded
+///
+/// a parsed batch may go on to the hull stage once its sequence number is below next + window, where next is the batch the
+/// writer waits for; that one always can, so a slow batch holds back the ones after it in the parse threads instead of piling
+/// them up in the writer (the gate is before the hull stage: a hull thread never waits on it, so it cannot sit on a batch
+/// which comes later than the one the writer needs)
+class reorder_gate
+{
+public:
+    explicit reorder_gate(size_t window) : window(window ? window : 1) {}
+
+    /// @brief waits until batch seq may go to the writer
+    void wait(size_t seq)
+    {
+        unique_lock<mutex> lock(m);
+        moved.wait(lock, [&]
+                   { return seq < next + window; });
+    }
+
+    /// @brief the writer is now waiting for batch seq
+    void advance(size_t seq)
+    {
+        lock_guard<mutex> lock(m);
+        next = seq;
+        moved.notify_all();
+    }
+
+private:
+    size_t window;
+    size_t next = 0;
+    mutex m;
+    condition_variable moved;
+};
+
+/// @brief a piece of the input made of whole sets
+struct input_block
+{
+    size_t seq;
+    string bytes;
+};
+
+/// @brief the sets of one block, and then their hulls
+///
+/// set i is points[offsets[i] .. offsets[i+1]), its hull is hulls (or ids) [hull_offsets[i] .. hull_offsets[i+1])
+struct set_batch
+{
+    size_t seq;
+    size_t bytes = 0;
+    /// @brief bytes of an incomplete binary record at the end of the block (only the last block of a cut input has one)
+    size_t truncated = 0;
+    vector<Vector2> points;
+    vector<size_t> offsets{0};
+    vector<Vector2> hulls;
+    vector<int> ids;
+    vector<size_t> hull_offsets{0};
+    size_t sets() const { return offsets.size() - 1; }
+};
+
+/// @brief what a stage did, its threads add to it
+struct stage_stats
+{
+    const char *name;
+    unsigned threads = 1;
+    atomic<long long> sets{0}, points{0}, bytes{0};
+    /// @brief time spent working, not waiting on the queues, summed over the threads
+    atomic<long long> busy_ns{0};
+
+    explicit stage_stats(const char *name) : name(name) {}
+
+    /// @brief runs fn and counts its time as busy
+    template <class F>
+    void time(F fn)
+    {
+        auto start = timer::now();
+        fn();
+        busy_ns += chrono::duration_cast<chrono::nanoseconds>(timer::now() - start).count();
+    }
+};
+
+/// @brief end of the last whole record in buf (binary input), records are a uint32 count and count x y pairs
+size_t binary_cut(const string &buf)
+{
+    size_t pos = 0;
+    while (pos + 4 <= buf.size())
+    {
+        uint32_t n;
+        memcpy(&n, buf.data() + pos, 4);
+        size_t next = pos + 4 + (size_t)n * sizeof(Vector2);
+        if (next > buf.size())
+            break;
+        pos = next;
+    }
+    return pos;
+}
+
+/// @brief true if the line [begin, end) has only white space
+bool blank_line(const string &buf, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        if (buf[i] != ' ' && buf[i] != '\t' && buf[i] != '\r')
+            return false;
+    }
+    return true;
+}
+
+/// @brief end of the last blank line in buf (text input), 0 if there is none
+/// @param from the lines ending before it were already looked at
+size_t text_cut(const string &buf, size_t from)
+{
+    size_t i = buf.rfind('\n');
+    while (i != string::npos && i + 1 > from)
+    {
+        size_t start = i == 0 ? string::npos : buf.rfind('\n', i - 1);
+        if (blank_line(buf, start == string::npos ? 0 : start + 1, i))
+            return i + 1;
+        i = start;
+    }
+    return 0;
+}
+
+/// @brief reads the input and cuts it into blocks of whole sets (a set bigger than a block makes a bigger block)
+void read_stage(FILE *in, bool binary, size_t block_bytes, bounded_queue<input_block> &out, stage_stats &st)
+{
+    string carry;
+    size_t seq = 0;
+    bool eof = false;
+    while (!eof)
+    {
+        input_block block;
+        st.time([&]
+                {
+            block.bytes.swap(carry);
+            size_t old = block.bytes.size();
+            /// a set which does not fit in the carry doubles the read, so a big set is not copied over and over
+            size_t want = max(block_bytes, old);
+            block.bytes.resize(old + want);
+            size_t got = fread(&block.bytes[old], 1, want, in);
+            block.bytes.resize(old + got);
+            eof = got < want;
+            size_t cut = eof ? block.bytes.size() : binary ? binary_cut(block.bytes) : text_cut(block.bytes, old);
+            carry.assign(block.bytes, cut, string::npos);
+            block.bytes.resize(cut);
+            st.bytes += got; });
+        if (block.bytes.empty())
+            continue;
+        block.seq = seq++;
+        out.push(std::move(block));
+    }
+    out.done();
+}
+
+/// @brief turns a block into its sets
+void parse_block(const input_block &block, bool binary, set_batch &batch)
+{
+    batch.seq = block.seq;
+    batch.bytes = block.bytes.size();
+    const string &buf = block.bytes;
+    if (binary)
+    {
+        size_t pos = 0;
+        while (pos + 4 <= buf.size())
+        {
+            uint32_t n;
+            memcpy(&n, buf.data() + pos, 4);
+            /// the read stage only cuts after whole records, but the end of the input is passed as it is
+            if (n > (buf.size() - pos - 4) / sizeof(Vector2))
+                break;
+            size_t first = batch.points.size();
+            batch.points.resize(first + n);
+            memcpy(batch.points.data() + first, buf.data() + pos + 4, (size_t)n * sizeof(Vector2));
+            batch.offsets.push_back(batch.points.size());
+            pos += 4 + (size_t)n * sizeof(Vector2);
+        }
+        batch.truncated = buf.size() - pos;
+        return;
+    }
+    /// the string ends with a 0, so strtof stops there at the latest
+    const char *p = buf.c_str(), *end = p + buf.size();
+    while (p < end)
+    {
+        while (*p == ' ' || *p == '\t' || *p == '\r')
+            p++;
+        if (*p == '\n' || *p == 0)
+        {
+            /// a blank line (or the end of the block) ends the set
+            if (batch.points.size() > batch.offsets.back())
+                batch.offsets.push_back(batch.points.size());
+            if (*p == 0)
+                break;
+            p++;
+            continue;
+        }
+        char *next;
+        Vector2 v;
+        v.x = strtof(p, &next);
+        bool ok = next != p;
+        p = next;
+        v.y = strtof(p, &next);
+        ok = ok && next != p;
+        p = next;
+        if (ok)
+            batch.points.push_back(v);
+        /// anything else on the line is ignored
+        while (*p != '\n' && *p != 0)
+            p++;
+        if (*p == '\n')
+            p++;
+    }
+    if (batch.points.size() > batch.offsets.back())
+        batch.offsets.push_back(batch.points.size());
+}
+
+/// @brief computes the hulls of every set of the batch
+void hull_batch_sets(set_batch &batch, bool indices, ks_workspace &ws, ks_index_workspace_of<Vector2> &ws_ids)
+{
+    for (size_t s = 0; s < batch.sets(); s++)
+    {
+        const Vector2 *pts = batch.points.data() + batch.offsets[s];
+        int n = (int)(batch.offsets[s + 1] - batch.offsets[s]);
+        size_t first = batch.hull_offsets.back();
+        int h;
+        if (indices)
+        {
+            batch.ids.resize(first + n);
+            h = compute_hull_indices(hull_engine::automatic, pts, n, batch.ids.data() + first, ws_ids);
+            batch.ids.resize(first + h);
+        }
+        else
+        {
+            batch.hulls.resize(first + n);
+            h = compute_hull(hull_engine::automatic, pts, n, batch.hulls.data() + first, ws);
+            batch.hulls.resize(first + h);
+        }
+        batch.hull_offsets.push_back(first + h);
+    }
+}
+
+/// @brief serializes the hulls of a batch
+void write_batch(const set_batch &batch, bool indices, bool binary, string &out)
+{
+    out.clear();
+    char line[64];
+    for (size_t s = 0; s < batch.sets(); s++)
+    {
+        size_t first = batch.hull_offsets[s], last = batch.hull_offsets[s + 1];
+        if (binary)
+        {
+            uint32_t h = (uint32_t)(last - first);
+            out.append((const char *)&h, 4);
+            for (size_t i = first; i < last; i++)
+            {
+                if (indices)
+                {
+                    uint32_t id = (uint32_t)batch.ids[i];
+                    out.append((const char *)&id, 4);
+                }
+                else
+                    out.append((const char *)&batch.hulls[i], sizeof(Vector2));
+            }
+            continue;
+        }
+        for (size_t i = first; i < last; i++)
+        {
+            /// 9 significant digits give back the same float
+            int len = indices ? snprintf(line, sizeof(line), "%d\n", batch.ids[i])
+                              : snprintf(line, sizeof(line), "%.9g %.9g\n", batch.hulls[i].x, batch.hulls[i].y);
+            out.append(line, len);
+        }
+        out += '\n';
+    }
+}
+
+/// @brief writes a batch file of generated sets, text if the name ends with .txt
+int generate(const char *path, long long sets, int size, const char *name, uint64_t seed)
+{
+    workload w;
+    if (!workload_from_name(name, w.kind))
+    {
+        fprintf(stderr, "unknown distribution %s\n", name);
+        return 1;
+    }
+    size_t len = strlen(path);
+    bool text = len >= 4 && strcmp(path + len - 4, ".txt") == 0;
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open file %s\n", path);
+        return 1;
+    }
+    w.n = size;
+    vector<Vector2> points(size);
+    for (long long s = 0; s < sets; s++)
+    {
+        w.seed = seed + s;
+        generate_points(w, points.data());
+        if (text)
+        {
+            for (auto p : points)
+                fprintf(file, "%.9g %.9g\n", p.x, p.y);
+            fputc('\n', file);
+        }
+        else
+        {
+            uint32_t n = (uint32_t)size;
+            fwrite(&n, 4, 1, file);
+            fwrite(points.data(), sizeof(Vector2), points.size(), file);
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 5 && strcmp(argv[1], "--generate") == 0)
+        return generate(argv[2], atoll(argv[3]), atoi(argv[4]), argc > 5 ? argv[5] : "uniform", argc > 6 ? strtoull(argv[6], nullptr, 10) : 1);
+
+    const char *input = nullptr, *output = nullptr;
+    int format = -1;
+    bool binary_out = false, indices = false;
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    unsigned parsers = max(1u, hardware / 4), workers = hardware;
+    size_t queue = 8, block_bytes = 4 << 20;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--text" || arg == "--binary")
+            format = arg == "--binary";
+        else if (arg == "--binary-out")
+            binary_out = true;
+        else if (arg == "--indices")
+            indices = true;
+        else if (arg == "--out" && has_value)
+            output = argv[++i];
+        else if (arg == "--parsers" && has_value)
+            parsers = max(1, atoi(argv[++i]));
+        else if (arg == "--workers" && has_value)
+            workers = max(1, atoi(argv[++i]));
+        else if (arg == "--queue" && has_value)
+            queue = max(1, atoi(argv[++i]));
+        else if (arg == "--block" && has_value)
+            block_bytes = max(1LL, atoll(argv[++i]));
+        else if (arg.size() > 1 && arg[0] == '-' && arg != "-")
+        {
+            fprintf(stderr, "usage: hull_cli [--text|--binary] [--out file] [--binary-out] [--indices] [--parsers n] [--workers n]\n"
+                            "                [--queue n] [--block bytes] [input]\n"
+                            "       hull_cli --generate <file> <sets> <points> [distribution] [seed]\n");
+            return 1;
+        }
+        else
+            input = argv[i];
+    }
+    bool from_stdin = !input || strcmp(input, "-") == 0;
+    size_t len = from_stdin ? 0 : strlen(input);
+    bool binary = format >= 0 ? format == 1 : !from_stdin && !(len >= 4 && strcmp(input + len - 4, ".txt") == 0);
+    FILE *in = from_stdin ? stdin : fopen(input, "rb");
+    FILE *out = output ? fopen(output, "wb") : stdout;
+    if (!in || !out)
+    {
+        fprintf(stderr, "Failed to open file %s\n", !in ? input : output);
+        return 1;
+    }
+
+    stage_stats read_st("read"), parse_st("parse"), hull_st("hull"), write_st("write");
+    parse_st.threads = parsers;
+    hull_st.threads = workers;
+    bounded_queue<input_block> blocks(queue, 1);
+    bounded_queue<set_batch> parsed(queue, (int)parsers);
+    bounded_queue<set_batch> hulled(queue, (int)workers);
+    reorder_gate gate(queue);
+
+    auto start = timer::now();
+    vector<thread> threads;
+    threads.emplace_back([&]
+                         { read_stage(in, binary, block_bytes, blocks, read_st); });
+    for (unsigned t = 0; t < parsers; t++)
+    {
+        threads.emplace_back([&]
+                             {
+            input_block block;
+            while (blocks.pop(block))
+            {
+                set_batch batch;
+                parse_st.time([&]
+                              { parse_block(block, binary, batch); });
+                parse_st.sets += batch.sets();
+                parse_st.points += batch.points.size();
+                parse_st.bytes += batch.bytes;
+                gate.wait(batch.seq);
+                parsed.push(std::move(batch));
+            }
+            parsed.done(); });
+    }
+    for (unsigned t = 0; t < workers; t++)
+    {
+        threads.emplace_back([&]
+                             {
+            ks_workspace ws;
+            ks_index_workspace_of<Vector2> ws_ids;
+            set_batch batch;
+            while (parsed.pop(batch))
+            {
+                hull_st.time([&]
+                             { hull_batch_sets(batch, indices, ws, ws_ids); });
+                hull_st.sets += batch.sets();
+                hull_st.points += batch.points.size();
+                /// the points are not needed any more, only the hulls go on
+                vector<Vector2>().swap(batch.points);
+                hulled.push(std::move(batch));
+            }
+            hulled.done(); });
+    }
+
+    /// the writer runs on this thread, the batches come out of order and wait in pending until it is their turn
+    /// (the gate keeps at most queue of them there)
+    map<size_t, set_batch> pending;
+    size_t next = 0, truncated = 0;
+    string text;
+    set_batch batch;
+    while (hulled.pop(batch))
+    {
+        size_t seq = batch.seq;
+        pending.emplace(seq, std::move(batch));
+        for (auto it = pending.find(next); it != pending.end(); it = pending.find(++next))
+        {
+            truncated += it->second.truncated;
+            write_st.time([&]
+                          {
+                write_batch(it->second, indices, binary_out, text);
+                fwrite(text.data(), 1, text.size(), out); });
+            write_st.sets += it->second.sets();
+            write_st.points += it->second.hull_offsets.back();
+            write_st.bytes += text.size();
+            pending.erase(it);
+        }
+        gate.advance(next);
+    }
+    for (auto &t : threads)
+        t.join();
+    fflush(out);
+    double seconds = chrono::duration<double>(timer::now() - start).count();
+    if (in != stdin)
+        fclose(in);
+    if (out != stdout)
+        fclose(out);
+
+    /// busy is the time the threads of a stage worked, util how much of the wall time they worked, rate the speed of one thread
+    fprintf(stderr, "%lld sets, %lld points, %.3f s\n", parse_st.sets.load(), parse_st.points.load(), seconds);
+    fprintf(stderr, "%-6s %7s %12s %14s %10s %8s %10s %12s\n", "stage", "threads", "sets", "points", "MB", "busy s", "util %", "Mpoints/s");
+    for (stage_stats *st : {&read_st, &parse_st, &hull_st, &write_st})
+    {
+        double busy = st->busy_ns / 1e9;
+        long long points = st == &read_st ? parse_st.points.load() : st->points.load();
+        fprintf(stderr, "%-6s %7u %12lld %14lld %10.1f %8.3f %10.1f %12.2f\n", st->name, st->threads,
+                st == &read_st ? parse_st.sets.load() : st->sets.load(), points, st->bytes / 1e6, busy,
+                100 * busy / (seconds * st->threads), busy > 0 ? points / busy / 1e6 : 0.0);
+    }
+    if (truncated)
+    {
+        fprintf(stderr, "the input ends with an incomplete record (%zu bytes), it was not hulled\n", truncated);
+        return 1;
+    }
+    return 0;
+}
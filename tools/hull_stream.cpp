@@ -0,0 +1,69 @@
+/// @file hull_stream.cpp
+/// @brief hull of a point file of any size with bounded memory
+///
+/// usage:
+///   hull_stream <file> [chunk_points]                     prints the hull of the file and the read throughput
+///   hull_stream --write <file> <n> [distribution] [seed]  writes n generated points as raw float32 pairs
+/// files ending with .txt are read as "x y" lines, anything else as raw little endian float32 pairs
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include "../engine/stream_hull.h"
+#include "../engine/workload.h"
+
+using namespace std;
+
+/// @brief writes n points of a distribution to a binary file, one block at a time so any n fits in memory
+int write_points(const char *path, long long n, const char *name, uint64_t seed)
+{
+    workload w;
+    if (!workload_from_name(name, w.kind))
+    {
+        printf("unknown distribution %s\n", name);
+        return 1;
+    }
+    w.n = n;
+    w.seed = seed;
+    FILE *file = fopen(path, "wb");
+    if (!file)
+    {
+        printf("Failed to open file %s\n", path);
+        return 1;
+    }
+    vector<Vector2> block(1 << 20);
+    for (long long first = 0; first < n; first += (long long)block.size())
+    {
+        size_t count = (size_t)min<long long>((long long)block.size(), n - first);
+        for (size_t i = 0; i < count; i++)
+            block[i] = workload_point(w, first + i);
+        fwrite(block.data(), sizeof(Vector2), count, file);
+    }
+    fclose(file);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 4 && strcmp(argv[1], "--write") == 0)
+        return write_points(argv[2], atoll(argv[3]), argc > 4 ? argv[4] : "uniform", argc > 5 ? strtoull(argv[5], nullptr, 10) : 1);
+    if (argc < 2)
+    {
+        printf("usage: hull_stream <file> [chunk_points]\n       hull_stream --write <file> <n> [distribution] [seed]\n");
+        return 1;
+    }
+    size_t chunk = argc > 2 ? (size_t)atoll(argv[2]) : (size_t)1 << 20;
+    vector<Vector2> hull;
+    auto start = chrono::steady_clock::now();
+    long long n = stream_hull_file(argv[1], chunk, hull);
+    if (n < 0)
+        return 1;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (auto p : hull)
+        printf("%g %g\n", p.x, p.y);
+    fprintf(stderr, "%lld points, %zu on the hull, %.3f s, %.1f MB/s\n", n, hull.size(), seconds,
+            n * sizeof(Vector2) / seconds / 1e6);
+    return 0;
+}
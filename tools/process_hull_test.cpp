@@ -0,0 +1,69 @@
+/// @file process_hull_test.cpp
+/// @brief runs the multi-process hull against the single process one and prints the speedup
+///
+/// usage: process_hull_test [n] [max_workers] [distribution] [numa]
+/// with "numa" the workers are pinned to the NUMA nodes (round robin), otherwise they are not pinned
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include "../engine/process_hull.h"
+#include "../engine/workload.h"
+
+using namespace std;
+
+/// @brief true if both hulls have the same points in the same order
+bool same_hull(const vector<Vector2> &a, const vector<Vector2> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a[i].x != b[i].x || a[i].y != b[i].y)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    workload w;
+    w.n = argc > 1 ? (size_t)atoll(argv[1]) : 4000000;
+    int max_workers = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 3 && !workload_from_name(argv[3], w.kind))
+    {
+        printf("unknown distribution %s\n", argv[3]);
+        return 1;
+    }
+    bool numa = argc > 4 && strcmp(argv[4], "numa") == 0;
+    vector<Vector2> points = generate_points(w);
+
+    /// the single process path: upper and lower hull of all the points with KS
+    vector<Vector2> expected(points.size());
+    ks_workspace ws;
+    auto start = chrono::steady_clock::now();
+    expected.resize(ks_hull(points.data(), (int)points.size(), expected.data(), ws));
+    double single = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    printf("%s n=%zu, %zu points on the hull\n", workload_name(w.kind), w.n, expected.size());
+    printf("%-10s %12s %10s %8s\n", "workers", "ms", "speedup", "same");
+    printf("%-10s %12.2f %10.2f %8s\n", "single", single, 1.0, "yes");
+
+    int failures = 0;
+    for (int workers = 1; workers <= max(1, max_workers); workers *= 2)
+    {
+        process_hull_options options;
+        options.workers = workers;
+        if (numa)
+            options.cpus = process_hull_numa_nodes();
+        vector<Vector2> hull;
+        start = chrono::steady_clock::now();
+        bool ok = process_hull(points, options, hull);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        bool same = same_hull(hull, expected);
+        failures += !same || !ok;
+        printf("%-10d %12.2f %10.2f %8s%s\n", workers, ms, single / ms, same ? "yes" : "NO", ok ? "" : " (a worker failed)");
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+// runs the scalar and the simd128 + pthreads wasm builds of hull_bench under node and compares them
+// usage: node wasm_bench.js [quick]
+
+const { execFileSync } = require("child_process");
+const path = require("path");
+
+const mode = process.argv[2] || "quick";
+
+function run(build) {
+    const script = path.join(__dirname, "hull_bench_" + build + ".js");
+    const output = execFileSync(process.execPath, [script, mode], { encoding: "utf8" });
+    const results = {};
+    let header = "";
+    for (const line of output.split("\n")) {
+        if (line.startsWith("#")) {
+            header = line;
+            continue;
+        }
+        const parts = line.trim().split(/\s+/);
+        if (parts.length === 3)
+            results[parts[0] + " " + parts[1]] = parseFloat(parts[2]);
+    }
+    return { header, results };
+}
+
+const scalar = run("scalar");
+const simd = run("simd");
+console.log("scalar: " + scalar.header);
+console.log("simd:   " + simd.header);
+console.log("case".padEnd(36) + "scalar ms".padStart(12) + "simd ms".padStart(12) + "speedup".padStart(10));
+for (const key of Object.keys(scalar.results)) {
+    const a = scalar.results[key];
+    const b = simd.results[key];
+    if (b === undefined)
+        continue;
+    console.log(key.padEnd(36) + a.toFixed(3).padStart(12) + b.toFixed(3).padStart(12) + (a / b).toFixed(2).padStart(10) + "x");
+}
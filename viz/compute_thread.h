@@ -0,0 +1,181 @@
+#pragma once
+
+/// @file compute_thread.h
+/// @brief runs the steps of a visualized algorithm away from the render loop and hands its state to the drawing code
+///
+/// the steps run on their own thread and, after a step, copy what is drawn into a snapshot_buffer; the render loop takes the
+/// newest snapshot once per frame, so a slow step never holds a frame back and a fast run is not limited to one step per frame
+/// the web build without -pthread has no threads, there the steps run inside pump() for a few milliseconds of every frame
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define VIZ_THREADS 1
+#endif
+
+/// @brief hands the newest value from one producer thread to one consumer thread without locks (triple buffering)
+///
+/// the producer fills write_buffer() and publishes it, the consumer takes the newest published value with update(); the third
+/// buffer lets both sides work at the same time, a value which is published twice before the consumer looks is just replaced
+template <class T>
+class snapshot_buffer
+{
+public:
+    /// @brief the buffer the producer fills, it is not seen by the consumer until publish()
+    T &write_buffer() { return buffers[back]; }
+
+    /// @brief makes the write buffer the newest value, the producer gets the buffer the newest value was in
+    void publish() { back = latest.exchange(back | fresh, std::memory_order_acq_rel) & index; }
+
+    /// @brief takes the newest value if one was published since the last call
+    /// @return true if read() changed
+    bool update()
+    {
+        if (!(latest.load(std::memory_order_acquire) & fresh))
+            return false;
+        front = latest.exchange(front, std::memory_order_acq_rel) & index;
+        return true;
+    }
+
+    /// @brief the value taken by the last update(), the consumer may move out of it (it is overwritten before it comes back)
+    T &read() { return buffers[front]; }
+
+private:
+    static const int index = 3, fresh = 4;
+    T buffers[3];
+    std::atomic<int> latest{2};
+    int back = 0;
+    int front = 1;
+};
+
+/// @brief runs step() until it returns false, with a pause between steps, and calls publish() after the steps
+class compute_thread
+{
+public:
+    ~compute_thread() { stop(); }
+
+    /// @brief at full speed (no pause) publish() is called at most this often, in seconds
+    double publish_period = 1.0 / 120;
+
+    /// @brief starts a run
+    /// @param step does one step on the state of the run, returns false when the run is over
+    /// @param publish copies the state into a snapshot, called after the step before each pause and after the last step
+    /// @param interval pause between two steps in seconds, 0 runs them back to back
+    void start(std::function<bool()> step, std::function<void()> publish, double interval)
+    {
+        stop();
+        step_fn = step;
+        publish_fn = publish;
+        pause = interval;
+        stopping = false;
+        active = true;
+        last_step = last_publish = clock::now() - std::chrono::hours(1);
+#if defined(VIZ_THREADS)
+        worker = std::thread([this]
+                             { run(); });
+#endif
+    }
+
+    /// @brief stops the run and waits for the step in progress, after this the state of the run belongs to the caller again
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+#if defined(VIZ_THREADS)
+        if (worker.joinable())
+            worker.join();
+#endif
+        active = false;
+    }
+
+    /// @brief changes the pause between steps, a pause in progress ends right away
+    void set_interval(double interval)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pause = interval;
+        }
+        wake.notify_all();
+    }
+
+    /// @brief true until the last step is done (or stop())
+    bool running() const { return active; }
+
+    /// @brief called once per frame: without threads the steps run here, for at most budget seconds
+    void pump(double budget = 0.008)
+    {
+#if !defined(VIZ_THREADS)
+        if (!active)
+            return;
+        clock::time_point begin = clock::now();
+        bool stepped = false;
+        while (active && clock::now() - begin < seconds(budget))
+        {
+            if (clock::now() - last_step < seconds(pause))
+                break;
+            last_step = clock::now();
+            active = step_fn();
+            stepped = true;
+            if (pause > 0)
+                break;
+        }
+        if (stepped)
+            publish_fn();
+#else
+        (void)budget;
+#endif
+    }
+
+private:
+    typedef std::chrono::steady_clock clock;
+    static clock::duration seconds(double s) { return std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(s)); }
+
+#if defined(VIZ_THREADS)
+    void run()
+    {
+        while (true)
+        {
+            bool more = step_fn();
+            clock::time_point now = clock::now();
+            double interval;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                interval = pause;
+            }
+            if (!more || interval > 0 || now - last_publish >= seconds(publish_period))
+            {
+                publish_fn();
+                last_publish = now;
+            }
+            if (!more)
+                break;
+            std::unique_lock<std::mutex> lock(mutex);
+            /// a new interval wakes the pause up, it then waits for what is left of the new one
+            while (!stopping && pause > 0 && clock::now() < now + seconds(pause))
+                wake.wait_until(lock, now + seconds(pause));
+            if (stopping)
+                break;
+        }
+        active = false;
+    }
+
+    std::thread worker;
+#endif
+
+    std::function<bool()> step_fn;
+    std::function<void()> publish_fn;
+    double pause = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> active{false};
+    std::mutex mutex;
+    std::condition_variable wake;
+    clock::time_point last_step, last_publish;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+/// @file frame_telemetry.h
+/// @brief per frame timing of the main loop of the visualizers, split into input, algorithm step, draw and present
+///
+/// the loop calls mark() after each part of the frame and end_frame() after EndDrawing()
+/// it keeps p50/p99 over the last frames, can draw them with a graph of the recent frames, and can write every frame to a CSV file
+/// present is the time spent in EndDrawing(), which includes the wait of SetTargetFPS(), so a frame that is on time has a big present
+
+#include <raylib.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/// @brief the parts of a frame
+enum frame_phase
+{
+    phase_input,
+    phase_compute,
+    phase_draw,
+    phase_present,
+    phase_count
+};
+
+class frame_telemetry
+{
+public:
+    /// @param window number of recent frames the percentiles and the graph use
+    explicit frame_telemetry(size_t window = 600) : window(window) { start(); }
+
+    /// @brief draw() does nothing unless this is set
+    bool show = false;
+
+    /// @brief starts timing a frame, call it at the top of the loop (end_frame() does it too)
+    void start()
+    {
+        last = clock::now();
+        for (int i = 0; i < phase_count; i++)
+            current.ms[i] = 0;
+    }
+
+    /// @brief the time since the previous mark (or since the frame started) is counted for phase
+    void mark(frame_phase phase)
+    {
+        clock::time_point now = clock::now();
+        current.ms[phase] += std::chrono::duration<float, std::milli>(now - last).count();
+        last = now;
+    }
+
+    /// @brief the frame is over, it is stored and the next one starts
+    void end_frame()
+    {
+        if (history.size() < max_history)
+            history.push_back(current);
+        else
+            history[next++ % max_history] = current;
+        start();
+    }
+
+    /// @brief percentile q (0..1) of a phase over the recent frames, phase_count gives the whole frame
+    float percentile(int phase, float q) const
+    {
+        size_t n = std::min(window, history.size());
+        if (n == 0)
+            return 0;
+        scratch.resize(n);
+        for (size_t i = 0; i < n; i++)
+            scratch[i] = value(recent(i), phase);
+        size_t k = std::min(n - 1, (size_t)(q * n));
+        std::nth_element(scratch.begin(), scratch.begin() + k, scratch.end());
+        return scratch[k];
+    }
+
+    /// @brief draws the percentiles and a graph of the recent frames (one column per frame, one color per phase)
+    void draw(int x, int y) const
+    {
+        if (!show)
+            return;
+        static const char *names[] = {"input", "step", "draw", "present", "frame"};
+        static const Color colors[] = {ORANGE, RED, SKYBLUE, GRAY, WHITE};
+        int columns = (int)std::min<size_t>(std::min(window, history.size()), 300);
+        /// 16.7 ms (one frame at 60 fps) is 50 pixels high
+        const float scale = 3;
+        DrawRectangle(x, y, 300, 140, Fade(BLACK, 0.6f));
+        for (int c = 0; c < columns; c++)
+        {
+            const frame &f = recent(columns - 1 - c);
+            float bottom = y + 60;
+            for (int p = 0; p < phase_count; p++)
+            {
+                float h = std::min(f.ms[p] * scale, bottom - y);
+                DrawLine(x + c, (int)bottom, x + c, (int)(bottom - h), colors[p]);
+                bottom -= h;
+            }
+        }
+        DrawLine(x, y + 60 - (int)(16.7f * scale), x + 300, y + 60 - (int)(16.7f * scale), WHITE);
+        for (int p = 0; p <= phase_count; p++)
+            DrawText(TextFormat("%-8s p50 %6.2f  p99 %6.2f ms", names[p], percentile(p, 0.5f), percentile(p, 0.99f)), x + 5, y + 64 + 15 * p, 10, colors[p]);
+    }
+
+    /// @brief writes every stored frame to a CSV file (one line per frame, times in milliseconds)
+    /// @return false if the file cant be written
+    bool write_csv(const char *path) const
+    {
+        FILE *file = fopen(path, "w");
+        if (!file)
+            return false;
+        fprintf(file, "frame,input_ms,step_ms,draw_ms,present_ms,frame_ms\n");
+        size_t n = history.size();
+        for (size_t i = 0; i < n; i++)
+        {
+            const frame &f = recent(n - 1 - i);
+            fprintf(file, "%zu,%.4f,%.4f,%.4f,%.4f,%.4f\n", i, f.ms[0], f.ms[1], f.ms[2], f.ms[3], value(f, phase_count));
+        }
+        fclose(file);
+        return true;
+    }
+
+private:
+    typedef std::chrono::steady_clock clock;
+    struct frame
+    {
+        float ms[phase_count];
+    };
+
+    /// @brief time of a phase in a frame, phase_count is the sum of all of them
+    static float value(const frame &f, int phase)
+    {
+        if (phase < phase_count)
+            return f.ms[phase];
+        float total = 0;
+        for (int p = 0; p < phase_count; p++)
+            total += f.ms[p];
+        return total;
+    }
+
+    /// @brief the i-th most recent frame (0 is the last one)
+    const frame &recent(size_t i) const
+    {
+        size_t n = history.size();
+        size_t newest = n < max_history ? n - 1 : (next + max_history - 1) % max_history;
+        return history[(newest + max_history - i) % max_history];
+    }
+
+    /// @brief about 4 hours at 60 fps, after that the oldest frames are overwritten
+    static const size_t max_history = 1 << 20;
+    size_t window;
+    size_t next = 0;
+    std::vector<frame> history;
+    frame current;
+    clock::time_point last;
+    mutable std::vector<float> scratch;
+};
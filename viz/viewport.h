@@ -0,0 +1,141 @@
+#pragma once
+
+/// @file viewport.h
+/// @brief pan and zoom for the visualizers, and point drawing that scales to inputs of any size
+///
+/// the points live in world coordinates and a raylib Camera2D maps them to the drawing area of the window
+/// big point sets are drawn through a point_quadtree: what is off screen is skipped and where many points fall in a few pixels
+/// one density tile is drawn instead of every point, so the cost of a frame depends on the window and not on the input
+
+#include <raylib.h>
+#include <cmath>
+#include <vector>
+#include "../engine/point_quadtree.h"
+
+/// @brief the camera of a visualizer and its controls
+///
+/// mouse wheel zooms around the cursor, dragging with the right button pans, HOME goes back to the default view
+class viewport
+{
+public:
+    /// @param w width of the drawing area (it starts at the top left corner of the window)
+    /// @param h height of the drawing area
+    viewport(float w, float h) : area{0, 0, w, h} { reset(); }
+
+    /// @brief the camera used between begin() and end()
+    Camera2D camera;
+    /// @brief part of the window the world is drawn in, the rest is left for the text
+    Rectangle area;
+    /// @brief radius of a point on screen in pixels, it does not change with the zoom
+    float point_size = 5;
+    /// @brief a part of the tree smaller than this many pixels is drawn as one tile
+    float tile_size = 3;
+
+    /// @brief world coordinates are screen coordinates again
+    void reset()
+    {
+        camera.offset = {0, 0};
+        camera.target = {0, 0};
+        camera.rotation = 0;
+        camera.zoom = 1;
+    }
+
+    /// @brief shows the whole rectangle [x0,x1]x[y0,y1]
+    void fit(float x0, float y0, float x1, float y1)
+    {
+        float w = std::fmax(x1 - x0, 1e-6f), h = std::fmax(y1 - y0, 1e-6f);
+        camera.zoom = 0.95f * std::fmin(area.width / w, area.height / h);
+        camera.offset = {area.x + area.width / 2, area.y + area.height / 2};
+        camera.target = {(x0 + x1) / 2, (y0 + y1) / 2};
+    }
+
+    /// @brief handles the zoom and pan input of this frame
+    void update()
+    {
+        Vector2 mouse = GetMousePosition();
+        if (IsKeyPressed(KEY_HOME))
+            reset();
+        if (!contains(mouse))
+            return;
+        float wheel = GetMouseWheelMove();
+        if (wheel != 0)
+        {
+            /// keep the world point under the cursor where it is
+            Vector2 world = to_world(mouse);
+            camera.offset = mouse;
+            camera.target = world;
+            camera.zoom = std::fmax(camera.zoom * std::pow(1.25f, wheel), 1e-6f);
+        }
+        if (IsMouseButtonDown(MOUSE_RIGHT_BUTTON))
+        {
+            Vector2 delta = GetMouseDelta();
+            camera.target.x -= delta.x / camera.zoom;
+            camera.target.y -= delta.y / camera.zoom;
+        }
+    }
+
+    /// @brief true if the screen position is inside the drawing area
+    bool contains(Vector2 screen) const { return CheckCollisionPointRec(screen, area); }
+
+    /// @brief world position of a screen position (for the mouse clicks)
+    Vector2 to_world(Vector2 screen) const { return GetScreenToWorld2D(screen, camera); }
+
+    /// @brief radius of a point in world units
+    float radius() const { return point_size / camera.zoom; }
+
+    /// @brief the part of the world which is on screen
+    Rectangle visible() const
+    {
+        Vector2 a = to_world({area.x, area.y});
+        Vector2 b = to_world({area.x + area.width, area.y + area.height});
+        return {a.x, a.y, b.x - a.x, b.y - a.y};
+    }
+
+    /// @brief starts drawing in world coordinates, clipped to the drawing area
+    void begin()
+    {
+        BeginScissorMode((int)area.x, (int)area.y, (int)area.width, (int)area.height);
+        BeginMode2D(camera);
+    }
+
+    /// @brief back to screen coordinates
+    void end()
+    {
+        EndMode2D();
+        EndScissorMode();
+    }
+
+    /// @brief draws the points which are on screen
+    void draw_points(const std::vector<Vector2> &pts, Color color) const
+    {
+        Rectangle view = grown(visible(), radius());
+        for (auto &p : pts)
+        {
+            if (CheckCollisionPointRec(p, view))
+                DrawCircleV(p, radius(), color);
+        }
+    }
+
+    /// @brief draws the points of the tree which are on screen, the dense parts as tiles
+    ///
+    /// a tile is more opaque the more points it has (log scale), a single point in a tile is still drawn as a point
+    void draw_points(const point_quadtree &tree, Color color) const
+    {
+        Rectangle view = grown(visible(), radius());
+        float r = radius();
+        tree.query(view.x, view.y, view.x + view.width, view.y + view.height, tile_size / camera.zoom, [&](const Vector2 *pts, size_t n)
+                   {
+            for (size_t i = 0; i < n; i++)
+            {
+                if (CheckCollisionPointRec(pts[i], view))
+                    DrawCircleV(pts[i], r, color);
+            } },
+                   [&](const point_quadtree::node &nd)
+                   {
+            float alpha = std::fmin(1.0f, 0.25f + std::log2((float)(nd.end - nd.begin)) / 16);
+            DrawRectangleRec({nd.x0, nd.y0, nd.x1 - nd.x0, nd.y1 - nd.y0}, Fade(color, alpha)); });
+    }
+
+private:
+    static Rectangle grown(Rectangle r, float by) { return {r.x - by, r.y - by, r.width + 2 * by, r.height + 2 * by}; }
+};
@@ -2,6 +2,13 @@
 #include <raylib.h>
 #include <raymath.h>
 #include<vector>
+#include <cstring>
+#include "../../engine/workload.h"
+#include "../../engine/hull.h"
+#include "../../engine/stream_hull.h"
+#include "../../viz/viewport.h"
+#include "../../viz/frame_telemetry.h"
+#include "../../viz/compute_thread.h"
 
 using namespace std;
 
@@ -9,8 +16,10 @@ using namespace std;
 int width=800;
 /// @brief height of the screen
 int height=500;
-/// @brief last time we executed a step of the code
-double lastUpdateTime=0;
+/// @brief pan and zoom of the drawing area (everything above the text bar)
+viewport view(width, height-50);
+/// @brief timing of the frames, T shows it and F2 writes it to frame_times.csv
+frame_telemetry telemetry;
 
 /// @brief this is the class encapsulating the points,and its functions
 class Points{
@@ -30,6 +39,16 @@ public:
     /// @brief stores the points incase user wants to restart
     vector<Vector2>restart;
 
+    /// @brief the hull of a file given on the command line, computed by the engine so big inputs can be looked at right away
+    vector<Vector2>loaded_hull;
+
+    /// @brief above this many points they are drawn from the quadtree
+    size_t tree_threshold=20000;
+    /// @brief quadtree of points_location, used for drawing big inputs
+    point_quadtree tree;
+    /// @brief points_location when the tree was built (the tree is rebuilt when the vector changes size or moves)
+    const Vector2 *tree_source=nullptr;
+
     /// @brief this checks if the points clash
     /// @param p1 point 1
     /// @param p2 point 2
@@ -61,43 +80,75 @@ public:
     /// @brief this adds the point to points_location
     /// @param new_point the point clicked by the user
     ///@note it uses the isvalid_point() function to determine if its valid
-    ///@attention if a point is clicked on the edge it shifts it so that it can fit in frame
+    ///@attention the point is in world coordinates (see viewport), it can be anywhere since the view can be moved to it
     void add_point(Vector2 new_point)
     {
-        if(new_point.y>height-50)
-            return;
-        
-        if(new_point.x<6)
-            new_point.x=6;
-        else if(new_point.x>width-6)
-            new_point.x=width-6;    
-        if(new_point.y<6)
-            new_point.y=6;
-        else if(new_point.y>height-56)
-            new_point.y=height-56;   
-
         if(isvalid_point(new_point))       
             points_location.push_back(new_point);
         
     }
 
+    /// @brief loads the points of a file (raw float32 x y pairs, or "x y" lines if the name ends with .txt)
+    ///
+    ///the points are not checked for clashes so files of any size can be looked at, the view is moved to show all of them
+    ///@return false if the file cant be opened
+    bool load_file(const char *path)
+    {
+        FILE *file = fopen(path, "rb");
+        if (!file)
+        {
+            printf("Failed to open file %s\n", path);
+            return false;
+        }
+        size_t len = strlen(path);
+        bool text = len >= 4 && strcmp(path + len - 4, ".txt") == 0;
+        vector<Vector2> chunk(1 << 20);
+        size_t got;
+        while ((got = stream_read_points(file, text, chunk.data(), chunk.size())) > 0)
+            points_location.insert(points_location.end(), chunk.begin(), chunk.begin() + got);
+        fclose(file);
+        if (points_location.empty())
+            return true;
+        loaded_hull = compute_hull(hull_engine::automatic, points_location);
+        float x0 = loaded_hull[0].x, y0 = loaded_hull[0].y, x1 = x0, y1 = y0;
+        for (auto p : loaded_hull)
+        {
+            x0 = min(x0, p.x);
+            x1 = max(x1, p.x);
+            y0 = min(y0, p.y);
+            y1 = max(y1, p.y);
+        }
+        view.fit(x0, y0, x1, y1);
+        return true;
+    }
+
     /// @brief draws the points on screen
-    /// @note the points are while colour
+    /// @note the points are while colour, only the ones in view are drawn (and big inputs go through the quadtree)
     void draw()
     {
-        for(auto itr:points_location)
+        if(points_location.size()>tree_threshold)
+        {
+            if(tree.size()!=points_location.size() || tree_source!=points_location.data())
+            {
+                tree.build(points_location);
+                tree_source=points_location.data();
+            }
+            view.draw_points(tree,WHITE);
+        }
+        else
+        {
+            view.draw_points(points_location,WHITE);
+        }
+        for(unsigned i=0;i<loaded_hull.size();i++)
         {
-            DrawCircle(itr.x,itr.y,5,WHITE);
+            DrawLineV(loaded_hull[i],loaded_hull[(i+1)%loaded_hull.size()],YELLOW);
         }
         
     }
     /// @brief draws the points which have already been computed
     void draw_blue()
     {
-        for(auto itr:blue)
-        {
-            DrawCircle(itr.x,itr.y,5,BLUE);
-        }
+        view.draw_points(blue,BLUE);
         
     }
 
@@ -108,17 +159,17 @@ public:
     {
         for(unsigned int i=1;i<points_in_hull.size()-1;i++)
         {
-            DrawLine(points_in_hull[i-1].x,points_in_hull[i-1].y,points_in_hull[i].x,points_in_hull[i].y,WHITE);
+            DrawLineV(points_in_hull[i-1],points_in_hull[i],WHITE);
         }
         int i=points_in_hull.size()-1;
         if(over)
         {
         
-            DrawLine(points_in_hull[i-1].x,points_in_hull[i-1].y,points_in_hull[i].x,points_in_hull[i].y,WHITE);
+            DrawLineV(points_in_hull[i-1],points_in_hull[i],WHITE);
         }
         else
         {
-            DrawLine(points_in_hull[i-1].x,points_in_hull[i-1].y,points_in_hull[i].x,points_in_hull[i].y,BLACK);
+            DrawLineV(points_in_hull[i-1],points_in_hull[i],BLACK);
         }
     }
     /// @brief finds the leftmost point 
@@ -144,9 +195,8 @@ public:
     /// @return if its 0 rhen colinear ,if 2 then clockwise
     int orientation(Vector2 p, Vector2 q, Vector2 r) 
     {
-        int val = (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
-        if (val == 0) return 0; 
-        return (val > 0) ? 1 : 2; 
+        /// same formula as before but in double (engine/hull_point.h), storing it in an int truncated small crossproducts to 0
+        return hull_orientation(p, q, r);
     }
     /// @brief calculates if i can be the next point on hull
     /// @param cur current final point on hull
@@ -165,10 +215,7 @@ public:
     /// @brief draws the points which cant be a part of the hull as black
     void draw_invalid()
     {
-        for(auto itr:invalid)
-        {
-            DrawCircle(itr.x,itr.y,5,BLACK);
-        }
+        view.draw_points(invalid,BLACK);
         
     }
     /// @brief draws the line below which the points are invalid :a point is invalid if it cant be a part of the remaining hull
@@ -177,7 +224,7 @@ public:
     ///@note it is in red colour
     void draw_invalid_line(Vector2 start,Vector2 cur)
     {
-        DrawLine(start.x,start.y,cur.x,cur.y,RED);
+        DrawLineV(start,cur,RED);
     }
 
     /// @brief finds the invalid points, all points below the invalid line are invalid 
@@ -201,18 +248,24 @@ public:
         points_location=temp;
         
     }
+    /// @brief seed of the next batch of random points, the same seed always gives the same points
+    uint64_t random_seed = 1;
+
     /// @brief adds 30 points randomly
+    ///
+    ///the points come from the seeded generator in engine/workload.h, so every run of the program gives the same sequence of inputs
     ///@note if any point is invalid we discard it(hence the number of points can be less than 30)
     void add_random()
     {
-        for(int i=0;i<30;i++)
+        workload w;
+        w.kind = workload_kind::uniform_square;
+        w.n = 30;
+        w.seed = random_seed++;
+        w.width = 800;
+        w.height = 450;
+        for (auto random_point : generate_points(w))
         {
-            Vector2 random_point;
-            float x= GetRandomValue(0, 800),y= GetRandomValue(0, 450);
-            random_point.x=x;
-            random_point.y=y;
             add_point(random_point);
-
         }
     }
     // @brief it adds the points present in the file input points
@@ -238,24 +291,113 @@ public:
 
 };
 
-/// @brief this function is used so that the next step of the algo is executed after some time 
-/// @param interval the time to wait
-/// @return if we can go ahead with the next step or not
-bool EventTriggered(double interval)
+/// @brief what the screen shows of a run, copied from the run by the compute thread after its steps
+struct JarvisSnapshot
+{
+    vector<Vector2>points_location,points_in_hull,blue,invalid;
+    Vector2 start_locn,cur_point_locn;
+    /// @brief the point compared in the last step, the blue line goes from the current hull point to it
+    Vector2 probe;
+    bool has_probe=0;
+    bool over=0;
+    /// @brief the run it comes from, a snapshot of a run which was stopped is not shown
+    int run=0;
+};
+
+/// @brief the state of a run of the jarvis march, it is stepped on the compute thread (see viz/compute_thread.h)
+struct JarvisRun
 {
-    double currentTime = GetTime();
-    if (currentTime - lastUpdateTime >= interval)
+    Points points;
+    int cur_point,start,n,i,next;
+    Vector2 cur_point_locn,start_locn;
+    bool over=0;
+    Vector2 probe;
+    bool has_probe=0;
+    int run=0;
+
+    /// @brief starts the march on the given points
+    void begin(const vector<Vector2>&locations)
     {
-        lastUpdateTime = currentTime;
-        return true;
+        points.points_location=locations;
+        points.points_in_hull={};
+        points.blue={};
+        points.invalid={};
+        over=0;
+        has_probe=0;
+        run++;
+        start=points.find_left();
+        points.points_in_hull.push_back(points.points_location[start]);
+        start_locn=points.points_location[start];
+        cur_point_locn=start_locn;
+        cur_point=start;
+        n=(int)points.points_location.size();
+        next=(cur_point+1) % points.points_location.size();
+        i=0;
+    }
+
+    /// @brief the next step of the march: compares one point, or moves to the next hull point when all of them are compared
+    /// @return false when the hull is complete
+    bool step()
+    {
+        has_probe=0;
+        if(n==0)
+        {
+            points.points_location=points.invalid;
+            points.points_in_hull.push_back(start_locn);
+            over=1;
+            
+        }
+        else if(i==n)
+        {
+            cur_point=next;
+            cur_point_locn=points.points_location[cur_point];
+            next=(cur_point+1) % points.points_location.size();
+            points.get_invalid(start_locn,cur_point_locn);
+            n=points.points_location.size();
+            i=0;
+            points.blue={};
+        }
+        else
+        {
+
+            if(i!=0)
+            {
+                points.points_in_hull.pop_back();
+            }
+            next=points.calculate_next(cur_point_locn,next,i);
+            probe=points.points_location[i];
+            has_probe=1;
+            points.blue.push_back(points.points_location[i]);
+            points.points_in_hull.push_back(points.points_location[next]);
+
+
+            i++;
+
+        }
+        return !over;
+    }
+
+    /// @brief copies what is drawn into a snapshot
+    void copy_to(JarvisSnapshot &s) const
+    {
+        s.points_location=points.points_location;
+        s.points_in_hull=points.points_in_hull;
+        s.blue=points.blue;
+        s.invalid=points.invalid;
+        s.start_locn=start_locn;
+        s.cur_point_locn=cur_point_locn;
+        s.probe=probe;
+        s.has_probe=has_probe;
+        s.over=over;
+        s.run=run;
     }
-    return false;
-}
+};
 
 /// @brief the window is made here
 ///@attention raylib library is used to make the window
 
-int main()
+/// @param argc with an argument, the points of that file are loaded (see Points::load_file())
+int main(int argc, char **argv)
 {
     cout << "Starting the screen..." << endl;
     InitWindow(width, height, "try1");
@@ -263,21 +405,63 @@ int main()
     Color green ={20,168,133,255};
     bool select_stage=1;
     Points points;
-    int cur_point,start;
     Vector2 cur_point_locn,start_locn;
     bool over=0;
-    int n,i=0;
-    int next;
     float time=.1;
+    /// @brief the steps run on the worker, the screen shows the newest snapshot of the run
+    JarvisRun run;
+    compute_thread worker;
+    snapshot_buffer<JarvisSnapshot> snapshots;
+    Vector2 probe;
+    bool has_probe=0;
+    /// @brief starts a run on the given points, the render side shows its first state until the first snapshot comes
+    auto start_run=[&](const vector<Vector2>&locations)
+    {
+        worker.stop();
+        run.begin(locations);
+        points.points_location=run.points.points_location;
+        points.points_in_hull=run.points.points_in_hull;
+        points.blue={};
+        points.invalid={};
+        start_locn=run.start_locn;
+        cur_point_locn=run.cur_point_locn;
+        has_probe=0;
+        over=0;
+        select_stage=0;
+        time=0.1;
+        worker.start([&]
+                     { return run.step(); },
+                     [&]
+                     {
+                         run.copy_to(snapshots.write_buffer());
+                         snapshots.publish();
+                     },
+                     time);
+    };
+    if(argc>1)
+    {
+        points.load_file(argv[1]);
+    }
+    telemetry.start();
     while (WindowShouldClose() == false)
     {
         BeginDrawing();
+        /// mouse wheel zooms, right drag pans, home resets the view
+        view.update();
+        if(IsKeyPressed(KEY_T))
+        {
+            telemetry.show=!telemetry.show;
+        }
+        if(IsKeyPressed(KEY_F2))
+        {
+            telemetry.write_csv("frame_times.csv");
+        }
         if(select_stage)
         {
             /// if user left clicks a point add it to point_location if it is a valid location
-            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && view.contains(GetMousePosition()))
             {
-                Vector2 mousePosition = GetMousePosition();
+                Vector2 mousePosition = view.to_world(GetMousePosition());
                 
                 printf("Mouse clicked at: %f, %f\n", mousePosition.x, mousePosition.y);
                 points.add_point(mousePosition);
@@ -301,30 +485,25 @@ int main()
             if(IsKeyPressed(KEY_DELETE))
             {
                 points.points_location={};
+                points.loaded_hull={};
             }
         }
+        telemetry.mark(phase_input);
         
         ///if user clicks eneter then move to next phase, i.e run the algo now
         if (!over && points.points_location.size()>2 && IsKeyPressed(KEY_ENTER)) 
         {
-            select_stage=0;
-            start=points.find_left();
-            points.points_in_hull.push_back(points.points_location[start]);
-            start_locn=points.points_location[start];
-            cur_point_locn=start_locn;
-            cur_point=start;
-            n=(int)points.points_location.size();
-            next=(cur_point+1) % points.points_location.size();
-            i=0;
-            time=0.1;
             points.restart=points.points_location;
+            start_run(points.points_location);
         }
         if(!select_stage && !over)
         {
             ///if user presses delete while running the algorithm then stop running the algorithm and then reset the screen
             if(IsKeyPressed(KEY_DELETE))
             {
+                worker.stop();
                 points.points_location={};
+                points.loaded_hull={};
                 points.blue={};
                 points.points_in_hull={};
                 points.invalid={};
@@ -336,50 +515,31 @@ int main()
             if(IsKeyPressed(KEY_RIGHT))
             {
                 time=0;
+                worker.set_interval(time);
             }
             ///reset speed of execution to .1 by left arrow
             if(IsKeyPressed(KEY_LEFT))
             {
                 time=0.1;
-            }
-            if (EventTriggered(time))
-            {
-                if(n==0)
-                {
-                    points.points_location=points.invalid;
-                    points.points_in_hull.push_back(start_locn);
-                    over=1;
-                    
-                }
-                else if(i==n)
-                {
-                    cur_point=next;
-                    cur_point_locn=points.points_location[cur_point];
-                    next=(cur_point+1) % points.points_location.size();
-                    points.get_invalid(start_locn,cur_point_locn);
-                    n=points.points_location.size();
-                    i=0;
-                    points.blue={};
-                }
-                else
-                {
-
-                    if(i!=0)
-                    {
-                        points.points_in_hull.pop_back();
-                    }
-                    next=points.calculate_next(cur_point_locn,next,i);
-                    DrawLine(cur_point_locn.x,cur_point_locn.y,points.points_location[i].x,points.points_location[i].y,BLUE);
-                    points.blue.push_back(points.points_location[i]);
-                    points.points_in_hull.push_back(points.points_location[next]);
-
-
-                    i++;
-
-                }
-                
+                worker.set_interval(time);
             }
         }
+        /// the steps themselves run on the worker, here the newest state of the run is taken for drawing
+        worker.pump();
+        if(snapshots.update() && snapshots.read().run==run.run && !select_stage)
+        {
+            JarvisSnapshot &s=snapshots.read();
+            points.points_location.swap(s.points_location);
+            points.points_in_hull.swap(s.points_in_hull);
+            points.blue.swap(s.blue);
+            points.invalid.swap(s.invalid);
+            start_locn=s.start_locn;
+            cur_point_locn=s.cur_point_locn;
+            probe=s.probe;
+            has_probe=s.has_probe;
+            over=s.over;
+        }
+        telemetry.mark(phase_compute);
 
         ClearBackground(green);
 
@@ -407,27 +567,12 @@ int main()
                 points.points_in_hull={};
                 points.points_location={};
                 points.invalid={};
+                points.loaded_hull={};
             }
             ///restart execution(re run the visualization of the algorithm with the same points)
             if(IsKeyPressed(KEY_R))
             {
-                points.points_in_hull={};
-                points.invalid={};
-
-                select_stage=0;
-                over=0;
-
-                points.points_location=points.restart;
-
-                start=points.find_left();
-                points.points_in_hull.push_back(points.points_location[start]);
-                start_locn=points.points_location[start];
-                cur_point_locn=start_locn;
-                cur_point=start;
-                n=(int)points.points_location.size();
-                next=(cur_point+1) % points.points_location.size();
-                i=0;
-                time=0.1;
+                start_run(points.restart);
                 continue;
 
             }
@@ -437,6 +582,7 @@ int main()
         {
             DrawText("algo visualization", 20, height-45, 40, WHITE);
         }  
+        view.begin();
         points.draw();
         points.draw_blue();
         if(!select_stage)
@@ -447,11 +593,17 @@ int main()
                 points.draw_invalid();
                 if(points.invalid.size()>2)
                     points.draw_invalid_line(start_locn,cur_point_locn);
+                if(has_probe)
+                    DrawLineV(cur_point_locn,probe,BLUE);
             }
         }   
-
+        view.end();
+        telemetry.draw(10, 10);
+        telemetry.mark(phase_draw);
 
         EndDrawing();
+        telemetry.mark(phase_present);
+        telemetry.end_frame();
     }
     CloseWindow();
     return 0;
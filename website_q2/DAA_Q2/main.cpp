@@ -4,14 +4,24 @@
 #include <vector>
 #include <stack>
 #include <algorithm>
+#include <cstring>
+#include "../../engine/hull_simd.h"
+#include "../../engine/workload.h"
+#include "../../engine/hull.h"
+#include "../../engine/stream_hull.h"
+#include "../../viz/viewport.h"
+#include "../../viz/frame_telemetry.h"
+#include "../../viz/compute_thread.h"
 
 using namespace std;
 /// @brief width of the screen
 int width = 800;
 /// @brief height of the screen
 int height = 500;
-/// @brief the last time we ran a step in the algorithm
-float lastUpdateTime = 0;
+/// @brief pan and zoom of the drawing area (everything above the text bar)
+viewport view(width, height - 50);
+/// @brief timing of the frames, T shows it and F2 writes it to frame_times.csv
+frame_telemetry telemetry;
 
 /// @brief a class which encapsulates all the functions required for the points
 ///
@@ -23,6 +33,16 @@ public:
     /// @brief stores the locations of the points
     vector<Vector2> points_location;
 
+    /// @brief the hull of a file given on the command line, computed by the engine so big inputs can be looked at right away
+    vector<Vector2> loaded_hull;
+
+    /// @brief above this many points they are drawn from the quadtree
+    size_t tree_threshold = 20000;
+    /// @brief quadtree of points_location, used for drawing big inputs
+    point_quadtree tree;
+    /// @brief points_location when the tree was built (the tree is rebuilt when the vector changes size or moves)
+    const Vector2 *tree_source = nullptr;
+
     /// @brief this checks if the points clash
     /// @param p1 point 1
     /// @param p2 point 2
@@ -54,67 +74,93 @@ public:
     /// @brief this adds the point to points_location
     /// @param new_point the point clicked by the user
     ///@note it uses the isvalid_point() function to determine if its valid
-    ///@attention if a point is clicked on the edge it shifts it so that it can fit in frame
+    ///@attention the point is in world coordinates (see viewport), it can be anywhere since the view can be moved to it
     void add_point(Vector2 new_point)
     {
-        if (new_point.y > height - 50) // out of screen
-            return;
-
-        // move the point slightly inside to fit
-        if (new_point.x < 6)
-            new_point.x = 6;
-        else if (new_point.x > width - 6)
-            new_point.x = width - 6;
-        if (new_point.y < 6)
-            new_point.y = 6;
-        else if (new_point.y > height - 56)
-            new_point.y = height - 56;
-
         if (isvalid_point(new_point))
             points_location.push_back(new_point);
     }
 
+    /// @brief loads the points of a file (raw float32 x y pairs, or "x y" lines if the name ends with .txt)
+    ///
+    ///the points are not checked for clashes so files of any size can be looked at, the view is moved to show all of them
+    ///@return false if the file cant be opened
+    bool load_file(const char *path)
+    {
+        FILE *file = fopen(path, "rb");
+        if (!file)
+        {
+            printf("Failed to open file %s\n", path);
+            return false;
+        }
+        size_t len = strlen(path);
+        bool text = len >= 4 && strcmp(path + len - 4, ".txt") == 0;
+        vector<Vector2> chunk(1 << 20);
+        size_t got;
+        while ((got = stream_read_points(file, text, chunk.data(), chunk.size())) > 0)
+            points_location.insert(points_location.end(), chunk.begin(), chunk.begin() + got);
+        fclose(file);
+        if (points_location.empty())
+            return true;
+        loaded_hull = compute_hull(hull_engine::automatic, points_location);
+        float x0 = loaded_hull[0].x, y0 = loaded_hull[0].y, x1 = x0, y1 = y0;
+        for (auto p : loaded_hull)
+        {
+            x0 = min(x0, p.x);
+            x1 = max(x1, p.x);
+            y0 = min(y0, p.y);
+            y1 = max(y1, p.y);
+        }
+        view.fit(x0, y0, x1, y1);
+        return true;
+    }
+
     /// @brief draws the points on screen
-    /// @note the points are while colour
+    /// @note the points are while colour, only the ones in view are drawn (and big inputs go through the quadtree)
     void draw()
     {
-        for (auto itr : points_location)
+        if (points_location.size() > tree_threshold)
+        {
+            if (tree.size() != points_location.size() || tree_source != points_location.data())
+            {
+                tree.build(points_location);
+                tree_source = points_location.data();
+            }
+            view.draw_points(tree, WHITE);
+        }
+        else
+        {
+            view.draw_points(points_location, WHITE);
+        }
+        for (unsigned i = 0; i < loaded_hull.size(); i++)
         {
-            DrawCircle(itr.x, itr.y, 5, WHITE);
+            DrawLineV(loaded_hull[i], loaded_hull[(i + 1) % loaded_hull.size()], YELLOW);
         }
     }
 
+    /// @brief seed of the next batch of random points, the same seed always gives the same points
+    uint64_t random_seed = 1;
+
     /// @brief adds 30 points randomly
+    ///
+    ///the points come from the seeded generator in engine/workload.h, so every run of the program gives the same sequence of inputs
     ///@note if any point is invalid we discard it(hence the number of points can be less than 30)
     void add_random()
     {
-        for(int i=0;i<30;i++)
+        workload w;
+        w.kind = workload_kind::uniform_square;
+        w.n = 30;
+        w.seed = random_seed++;
+        w.width = 800;
+        w.height = 450;
+        for (auto random_point : generate_points(w))
         {
-            Vector2 random_point;
-            float x= GetRandomValue(0, 800),y= GetRandomValue(0, 450);
-            random_point.x=x;
-            random_point.y=y;
             add_point(random_point);
-
         }
     }
 
 };
 
-/// @brief this function is used so that the next step of the algo is executed after some time 
-/// @param interval the time to wait
-/// @return if we can go ahead with the next step or not
-bool EventTriggered(float interval)
-{
-    float currentTime = GetTime();
-    if (currentTime - lastUpdateTime >= interval)
-    {
-        lastUpdateTime = currentTime;
-        return true;
-    }
-    return false;
-}
-
 /// @brief finds a pivot element to perform sorting based on pivot , it is used in finding the median in median of medians
 ///@note finds a pivot for an array of ** points**
 /// @return returns pivot
@@ -128,10 +174,11 @@ Vector2 findPivot(vector<Vector2> arr, int left, int right)
         temp.y=-1;
         return temp;
     }
+    auto by_x = [](const Vector2 &a, const Vector2 &b)
+    { return a.x < b.x; };
     if (n <= 5)
     {
-        sort(arr.begin() + left, arr.begin() + right + 1, [](const Vector2 &a, const Vector2 &b)
-             { return a.x < b.x; });
+        hull_small_sort(arr.data() + left, n, by_x);
         return arr[left + n / 2];
     }
 
@@ -141,8 +188,7 @@ Vector2 findPivot(vector<Vector2> arr, int left, int right)
     {
         int start = left + 5 * i;
         int end = min(left + 5 * i + 4, right);
-        sort(arr.begin() + start, arr.begin() + end + 1, [](const Vector2 &a, const Vector2 &b)
-             { return a.x < b.x; });
+        hull_small_sort(arr.data() + start, end - start + 1, by_x);
         medians.push_back(arr[start + (end - start) / 2]);
     }
     return findPivot(medians, 0, numMedians - 1);
@@ -162,6 +208,10 @@ Vector2 find_median(vector<Vector2> arr)
     int right = (int)arr.size() - 1;
     if (arr.size() == 1)
         return arr[0];
+    /// points given sorted by x stay sorted in every subproblem (the filters keep the order), then the median is the middle one
+    if (is_sorted(arr.begin(), arr.end(), [](const Vector2 &a, const Vector2 &b)
+                  { return a.x < b.x; }))
+        return arr[need_index];
 
     while (left <= right)
     {
@@ -232,10 +282,38 @@ Vector2 find_median(vector<Vector2> arr)
     return arr[0];
 }
 
+/// @brief slope of a pair of points (x0 < x1) kept as its two ends, the slope is (y0 - y1) / (x1 - x0) in the raylib orientation (-y is up)
+///
+///two slopes are compared by cross multiplication, so find_edge() never divides; the differences and products can round in
+///double, so the sign is taken with hull_det_sign(), which is exact (a float quotient compared with == split equal slopes)
+struct pair_slope
+{
+    double x0, y0;
+    double x1, y1;
+    bool operator<(const pair_slope &o) const { return hull_det_sign(y0, y1, o.x1, o.x0, o.y0, o.y1, x1, x0) < 0; }
+    bool operator>(const pair_slope &o) const { return o < *this; }
+    bool operator<=(const pair_slope &o) const { return !(o < *this); }
+    bool operator==(const pair_slope &o) const { return hull_det_sign(y0, y1, o.x1, o.x0, o.y0, o.y1, x1, x0) == 0; }
+    bool operator!=(const pair_slope &o) const { return !(*this == o); }
+};
+
+/// @brief the slope of the pair first -> second
+pair_slope slope_of(const pair<Vector2, Vector2> &pr)
+{
+    return {pr.first.x, pr.first.y, pr.second.x, pr.second.y};
+}
+
+/// @brief compares the intercepts c = -y - k*x of the lines of slope k through p and q, without dividing
+/// @return positive if the line through p is above the one through q, 0 if it is the same line
+int intercept_diff(pair_slope k, Vector2 p, Vector2 q)
+{
+    return hull_det_sign(q.y, p.y, k.x1, k.x0, k.y0, k.y1, p.x, q.x);
+}
+
 /// @brief finds a pivot element to perform sorting based on pivot , it is used in finding the median in median of medians
 ///@note finds a pivot for an array of ** float values**
 /// @return returns pivot
-float findPivot_slope(vector<float> arr, int left, int right)
+pair_slope findPivot_slope(vector<pair_slope> arr, int left, int right)
 {
     int n = right - left + 1;
     // if(left>right)
@@ -246,23 +324,22 @@ float findPivot_slope(vector<float> arr, int left, int right)
     //     return arr[left];
     if (right == -1)
     {
-        return 0;
+        return {0, 0, 1, 0};
     }
     if (n <= 5)
     {
-        sort(arr.begin() + left, arr.begin() + right + 1);
+        hull_small_sort(arr.data() + left, n);
         // cout<<n<<left;
         return arr[left + n / 2];
     }
 
     int numMedians = (n + 4) / 5;
-    vector<float> medians;
-    // float temp=
+    vector<pair_slope> medians;
     for (int i = 0; i < numMedians; i++)
     {
         int start = left + 5 * i;
         int end = min(start + 4, right);
-        sort(arr.begin() + start, arr.begin() + end + 1);
+        hull_small_sort(arr.data() + start, end - start + 1);
         medians.push_back(arr[start + (end - start) / 2]);
     }
 
@@ -273,10 +350,10 @@ float findPivot_slope(vector<float> arr, int left, int right)
 ///
 ///it finds the median using median of medians algorithm
 ///@attention it finds the median in O(n) time
-///@note this function finds the median of an array consisting of **float**
+///@note this function finds the median of an array consisting of **slopes** (see pair_slope)
 /// @param arr array of slopes
 /// @return median
-float find_median_slope(vector<float> arr)
+pair_slope find_median_slope(vector<pair_slope> arr)
 {
     int need_index = (int)arr.size() / 2;
     int left = 0;
@@ -285,10 +362,10 @@ float find_median_slope(vector<float> arr)
         return arr[0];
     while (left <= right)
     {
-        float pivot_value = findPivot_slope(arr, left, right);
+        pair_slope pivot_value = findPivot_slope(arr, left, right);
 
         int pivot = left;
-        if (pivot_value != 0)
+        if (pivot_value != pair_slope{0, 0, 1, 0})
         {
             for (int i = left; i <= right; i++)
             {
@@ -381,6 +458,10 @@ public:
     Vector2 curr_median;
     /// @brief used to store the subproblems states
     deque<info> s;
+    /// @brief if true find_edge() prunes with the slope of a random pair instead of the median slope
+    ///
+    ///the median of medians guarantees linear time in the worst case, a random slope is linear on average and much cheaper
+    bool random_slope = false;
 
     /// @brief finds the leftmost point in the upper hull
     /// @param points all the points 
@@ -490,7 +571,7 @@ public:
         }
 
         int m = n / 2;
-        vector<float> slopes;
+        vector<pair_slope> slopes;
         ///find the median of the slopes by calculating all slopes and then performing medians of medians
         for (int i = 0; i < m; i++)
         {
@@ -508,17 +589,16 @@ public:
             }
             else
             {
-                float temp = ((float)(-pairs[i].second.y + pairs[i].first.y)) / ((float)(pairs[i].second.x - pairs[i].first.x));
-                slopes.push_back(temp);
+                slopes.push_back(slope_of(pairs[i]));
             }
         }
-        float median_slope;
+        pair_slope median_slope;
         if (slopes.size())
-            median_slope = find_median_slope(slopes);
+            median_slope = random_slope ? slopes[GetRandomValue(0, (int)slopes.size() - 1)] : find_median_slope(slopes);
         else
         {
             /// if no slope exists then call the function again with possible candidates
-            find_edge(candidates, median);
+            return find_edge(candidates, median);
         }
 
         ///seperate the pairs in small large and equal , by compairing their slope with the median slope
@@ -529,11 +609,8 @@ public:
         {
             if (pairs[i].first.x == pairs[i].second.x)
                 continue;
-            float temp = ((float)(-pairs[i].second.y + pairs[i].first.y)) / ((float)(pairs[i].second.x - pairs[i].first.x));
-            float diff = (temp - median_slope);
-            // if (diff < 0)
-            //     diff = -diff;
-            if (diff == 0)
+            pair_slope temp = slope_of(pairs[i]);
+            if (temp == median_slope)
             {
                 equal.push_back(pairs[i]);
             }
@@ -546,26 +623,19 @@ public:
                 small.push_back(pairs[i]);
             }
         }
-        /// find the maximum c intercept of all points with median slope
-        float max_c = INT_MIN;
-        for (int i = 0; i < n; i++)
+        /// find the point with the maximum c intercept for the median slope
+        Vector2 top = points[0];
+        for (int i = 1; i < n; i++)
         {
-            float cur_c = -points[i].y - median_slope * points[i].x;
-            max_c = max(max_c, cur_c);
+            if (intercept_diff(median_slope, points[i], top) > 0)
+                top = points[i];
         }
-        // cout << max_c << endl;
-        Vector2 pmin;
-        Vector2 pmax;
-        pmin.x = INT_MAX;
-        pmax.x = INT_MIN;
+        Vector2 pmin = top;
+        Vector2 pmax = top;
         /// find leftmost and rightmost point with that intercept
         for (int i = 0; i < n; i++)
         {
-            float cur_c = -points[i].y - median_slope * points[i].x;
-            float diff = (cur_c - max_c);
-            if (diff < 0)
-                diff = -diff;
-            if (diff <= 0.0001)
+            if (intercept_diff(median_slope, points[i], top) == 0)
             {
                 if (points[i].x > pmax.x)
                 {
@@ -731,16 +801,10 @@ public:
     ///it reduces the number of valid points which can be part of the upper hull
     void find_hull_helper(vector<Vector2> &points, Vector2 left, Vector2 right)
     {
-        vector<Vector2> valid;
+        vector<Vector2> valid(points.size());
         /// all the points present above the left right line can be part of the hull
-        for (auto i : points)
-        {
-            if (orientation(left, right, i) == 1||orientation(left, right, i) == 0  )
-            {
-                valid.push_back(i);
-            }
-            
-        }
+        ///@note the check is vectorized (sse2 / wasm simd128) when available
+        valid.resize(hull_select_side(points.data(), (int)points.size(), left, right, 1, true, valid.data()));
         if (valid.size() == 0)
             return;
         find_hull(valid, left, right);
@@ -750,7 +814,7 @@ public:
     {
         for (auto i : upper_edges)
         {
-            DrawLine(i.first.x, i.first.y, i.second.x, i.second.y, WHITE);
+            DrawLineV(i.first, i.second, WHITE);
         }
     }
 };
@@ -772,6 +836,10 @@ public:
     Vector2 curr_median;
     /// @brief used to store the subproblems states
     deque<info> s;
+    /// @brief if true find_edge() prunes with the slope of a random pair instead of the median slope
+    ///
+    ///the median of medians guarantees linear time in the worst case, a random slope is linear on average and much cheaper
+    bool random_slope = false;
     /// @brief finds the leftmost point in the lower hull
     /// @param points all the points 
     /// @return left most point
@@ -883,7 +951,7 @@ public:
         }
 
         int m = n / 2;
-        vector<float> slopes;
+        vector<pair_slope> slopes;
         ///find the median of the slopes by calculating all slopes and then performing medians of medians
         for (int i = 0; i < m; i++)
         {
@@ -903,18 +971,16 @@ public:
             }
             else
             {
-                float temp = ((float)(-pairs[i].second.y + pairs[i].first.y)) / ((float)(pairs[i].second.x - pairs[i].first.x));
-                slopes.push_back(temp);
+                slopes.push_back(slope_of(pairs[i]));
             }
         }
-        float median_slope;
-        // median_slope = find_median_slope(slopes);
+        pair_slope median_slope;
         if (slopes.size())
-            median_slope = find_median_slope(slopes);
+            median_slope = random_slope ? slopes[GetRandomValue(0, (int)slopes.size() - 1)] : find_median_slope(slopes);
         else
         {
             /// if no slope exists then call the function again with possible candidates
-            find_edge(candidates, median);
+            return find_edge(candidates, median);
         }
         ///seperate the pairs in small large and equal , by compairing their slope with the median slope
         vector<pair<Vector2, Vector2>> small;
@@ -924,11 +990,8 @@ public:
         {
             if (pairs[i].first.x == pairs[i].second.x)
                 continue;
-            float temp = ((float)(-pairs[i].second.y + pairs[i].first.y)) / ((float)(pairs[i].second.x - pairs[i].first.x));
-            float diff = (temp - median_slope);
-            if (diff < 0)
-                diff = -diff;
-            if (diff == 0)
+            pair_slope temp = slope_of(pairs[i]);
+            if (temp == median_slope)
             {
                 equal.push_back(pairs[i]);
             }
@@ -941,25 +1004,19 @@ public:
                 small.push_back(pairs[i]);
             }
         }
-        float min_c = INT_MAX;
-        /// find the min c intercept of all points with median slope
-        for (int i = 0; i < n; i++)
+        /// find the point with the min c intercept for the median slope
+        Vector2 bottom = points[0];
+        for (int i = 1; i < n; i++)
         {
-            float cur_c = -points[i].y - median_slope * points[i].x;
-            min_c = min(min_c, cur_c);
+            if (intercept_diff(median_slope, points[i], bottom) < 0)
+                bottom = points[i];
         }
-        Vector2 pmin;
-        Vector2 pmax;
-        pmin.x = INT_MAX;
-        pmax.x = INT_MIN;
+        Vector2 pmin = bottom;
+        Vector2 pmax = bottom;
         /// find leftmost and rightmost point with that intercept
         for (int i = 0; i < n; i++)
         {
-            float cur_c = -points[i].y - median_slope * points[i].x;
-            float diff = (cur_c - min_c);
-            if (diff < 0)
-                diff = -diff;
-            if (diff <= 0.0001)
+            if (intercept_diff(median_slope, points[i], bottom) == 0)
             {
                 if (points[i].x > pmax.x)
                 {
@@ -1119,15 +1176,10 @@ public:
     ///it reduces the number of valid points which can be part of the upper hull
     void find_hull_helper(vector<Vector2> points, Vector2 left, Vector2 right)
     {
-        vector<Vector2> valid;
+        vector<Vector2> valid(points.size());
         /// all the points present below the left right line can be part of the hull
-        for (auto i : points)
-        {
-            if (orientation(left, right, i) == 2 || orientation(left, right, i) == 0)
-            {
-                valid.push_back(i);
-            }
-        }
+        ///@note the check is vectorized (sse2 / wasm simd128) when available
+        valid.resize(hull_select_side(points.data(), (int)points.size(), left, right, 2, true, valid.data()));
         if (valid.size() == 0)
             return;
         //valid=points;
@@ -1138,12 +1190,110 @@ public:
     {
         for (auto i : lower_edges)
         {
-            DrawLine(i.first.x, i.first.y, i.second.x, i.second.y, WHITE);
+            DrawLineV(i.first, i.second, WHITE);
+        }
+    }
+};
+
+/// @brief what the screen shows of a run, copied from the run by the compute thread after its steps
+struct HullSnapshot
+{
+    vector<pair<Vector2, Vector2>> upper_edges, lower_edges;
+    Vector2 upper_median, lower_median;
+    Vector2 upper_xmin, upper_xmax, lower_xmin, lower_xmax;
+    bool over = 0, lower = 0, first = 1;
+    /// @brief the run it comes from, a snapshot of a run which was stopped is not shown
+    int run = 0;
+};
+
+/// @brief the state of a run of the upper and then the lower hull, it is stepped on the compute thread (see viz/compute_thread.h)
+struct HullRun
+{
+    Upper_hull upper_hull;
+    Lower_hull lower_hull;
+    /// @brief over: the upper hull is done, lower: the lower hull is being computed, first: no lower step was done yet
+    bool over = 0, lower = 0, first = 1;
+    int run = 0;
+
+    /// @brief starts the upper hull on the given points, with the subproblem of the whole set on each stack
+    void begin(vector<Vector2> points, bool random_slope)
+    {
+        upper_hull.upper_edges = {};
+        lower_hull.lower_edges = {};
+        upper_hull.s = {};
+        lower_hull.s = {};
+        upper_hull.random_slope = random_slope;
+        lower_hull.random_slope = random_slope;
+        over = 0;
+        lower = 0;
+        first = 1;
+        run++;
+        struct info info_temp1;
+        info_temp1.left = upper_hull.find_xmin(points);
+        info_temp1.right = upper_hull.find_xmax(points);
+        info_temp1.points = points;
+        upper_hull.s.push_back(info_temp1);
+
+        struct info info_temp2;
+        info_temp2.left = lower_hull.find_xmin(points);
+        info_temp2.right = lower_hull.find_xmax(points);
+        info_temp2.points = points;
+        lower_hull.s.push_back(info_temp2);
+    }
+
+    /// @brief solves the next subproblem, of the upper hull until it is done and then of the lower hull
+    /// @return false when both hulls are done
+    bool step()
+    {
+        if (!over)
+        {
+            if (upper_hull.s.empty())
+            {
+                over = 1;
+                lower = 1;
+            }
+            else
+            {
+                struct info info_temp;
+                info_temp = upper_hull.s.front();
+                upper_hull.s.pop_front();
+                upper_hull.find_hull_helper(info_temp.points, info_temp.left, info_temp.right);
+            }
+            return true;
+        }
+        if (lower_hull.s.empty())
+        {
+            lower = 0;
+            return false;
         }
+        struct info info_temp;
+        info_temp = lower_hull.s.front();
+        lower_hull.s.pop_front();
+        lower_hull.find_hull_helper(info_temp.points, info_temp.left, info_temp.right);
+        first = 0;
+        return true;
+    }
+
+    /// @brief copies what is drawn into a snapshot
+    void copy_to(HullSnapshot &s) const
+    {
+        s.upper_edges = upper_hull.upper_edges;
+        s.lower_edges = lower_hull.lower_edges;
+        s.upper_median = upper_hull.curr_median;
+        s.lower_median = lower_hull.curr_median;
+        s.upper_xmin = upper_hull.xmin;
+        s.upper_xmax = upper_hull.xmax;
+        s.lower_xmin = lower_hull.xmin;
+        s.lower_xmax = lower_hull.xmax;
+        s.over = over;
+        s.lower = lower;
+        s.first = first;
+        s.run = run;
     }
 };
 
-int main()
+/// @param argc with an argument, the points of that file are loaded (see Points::load_file())
+int main(int argc, char **argv)
 {
     cout << "Starting the game..." << endl;
     InitWindow(width, height, "try1");
@@ -1155,19 +1305,57 @@ int main()
     Lower_hull lower_hull;
     bool lower = 0;
     bool over = 0;
-    Vector2 xmin_upper, xmax_upper;
-    Vector2 xmin_lower, xmax_lower;
     bool first = 1;
     float time=1;
+    /// @brief the steps run on the worker, the screen shows the newest snapshot of the run
+    HullRun run;
+    compute_thread worker;
+    snapshot_buffer<HullSnapshot> snapshots;
+    /// @brief starts a run on the points, the screen is cleared until the first snapshot comes
+    auto start_run = [&]()
+    {
+        worker.stop();
+        run.begin(points.points_location, upper_hull.random_slope);
+        upper_hull.upper_edges = {};
+        lower_hull.lower_edges = {};
+        over = 0;
+        lower = 0;
+        first = 1;
+        select_stage = 0;
+        time = 1;
+        worker.start([&]
+                     { return run.step(); },
+                     [&]
+                     {
+                         run.copy_to(snapshots.write_buffer());
+                         snapshots.publish();
+                     },
+                     time);
+    };
+    if (argc > 1)
+    {
+        points.load_file(argv[1]);
+    }
+    telemetry.start();
     while (WindowShouldClose() == false)
     {
         BeginDrawing();
+        /// mouse wheel zooms, right drag pans, home resets the view
+        view.update();
+        if (IsKeyPressed(KEY_T))
+        {
+            telemetry.show = !telemetry.show;
+        }
+        if (IsKeyPressed(KEY_F2))
+        {
+            telemetry.write_csv("frame_times.csv");
+        }
         if (select_stage)
         {
-            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && view.contains(GetMousePosition()))
             {
-                // Get mouse position
-                Vector2 mousePosition = GetMousePosition();
+                // Get mouse position in the world
+                Vector2 mousePosition = view.to_world(GetMousePosition());
 
                 // Print mouse position to console
                 printf("Mouse clicked at: %f, %f\n", mousePosition.x, mousePosition.y);
@@ -1192,111 +1380,68 @@ int main()
             if(IsKeyPressed(KEY_DELETE))
             {
                 points.points_location={};
+                points.loaded_hull={};
+            }
+            ///if user presses M then switch between the median of medians and a random slope for finding the bridge
+            if(IsKeyPressed(KEY_M))
+            {
+                upper_hull.random_slope = !upper_hull.random_slope;
+                lower_hull.random_slope = upper_hull.random_slope;
             }
         }
+        telemetry.mark(phase_input);
 
         if (!over && points.points_location.size() > 2 && IsKeyPressed(KEY_ENTER))
         {
-            select_stage = 0;
-            xmin_upper = upper_hull.find_xmin(points.points_location);
-            xmax_upper = upper_hull.find_xmax(points.points_location);
-            struct info info_temp1;
-            info_temp1.left = xmin_upper;
-            info_temp1.right = xmax_upper;
-            info_temp1.points = points.points_location;
-            upper_hull.s.push_back(info_temp1);
-
-            xmin_lower = lower_hull.find_xmin(points.points_location);
-            xmax_lower = lower_hull.find_xmax(points.points_location);
-            struct info info_temp2;
-            info_temp2.left = xmin_lower;
-            info_temp2.right = xmax_lower;
-            info_temp2.points = points.points_location;
-            lower_hull.s.push_back(info_temp2);
-            time=1;
+            start_run();
             // cout<<endl<<"found";
         }
-        if (!select_stage && !over)
+        if ((!select_stage && !over) || lower)
         {
             ///user can increase speed of execution by right arrow
             if(IsKeyPressed(KEY_RIGHT))
             {
                 time=0;
+                worker.set_interval(time);
             }
-            ///reset speed of execution to .1 by left arrow
+            ///reset speed of execution to 1 by left arrow
             if(IsKeyPressed(KEY_LEFT))
             {
                 time=1;
+                worker.set_interval(time);
             }
             if(IsKeyPressed(KEY_DELETE))
             {
+                worker.stop();
                 over = 0;
+                lower = 0;
                 select_stage = 1;
                 first = 1;
                 upper_hull.upper_edges = {};
                 lower_hull.lower_edges = {};
                 points.points_location = {};
-                upper_hull.s={};
-                lower_hull.s={};
+                points.loaded_hull = {};
                 continue;
             }
-
-            if (EventTriggered(time))
-            {
-                if (upper_hull.s.empty())
-                {
-                    over = 1;
-                    lower = 1;
-                }
-                else
-                {
-                    struct info info_temp;
-                    info_temp = upper_hull.s.front();
-                    upper_hull.s.pop_front();
-                    upper_hull.find_hull_helper(info_temp.points, info_temp.left, info_temp.right);
-                }
-            }
-        }
-
-        if (lower)
-        {
-            if(IsKeyPressed(KEY_RIGHT))
-            {
-                time=0;
-            }
-            if(IsKeyPressed(KEY_LEFT))
-            {
-                time=1;
-            }
-            if(IsKeyPressed(KEY_DELETE))
-            {
-                over = 0;
-                select_stage = 1;
-                first = 1;
-                upper_hull.upper_edges = {};
-                lower_hull.lower_edges = {};
-                points.points_location = {};
-                upper_hull.s={};
-                lower_hull.s={};
-                continue;
-            }
-            if (EventTriggered(time))
-            {
-
-                if (lower_hull.s.empty())
-                {
-                    lower = 0;
-                }
-                else
-                {
-                    struct info info_temp;
-                    info_temp = lower_hull.s.front();
-                    lower_hull.s.pop_front();
-                    lower_hull.find_hull_helper(info_temp.points, info_temp.left, info_temp.right);
-                    first = 0;
-                }
-            }
         }
+        /// the steps themselves run on the worker, here the newest state of the run is taken for drawing
+        worker.pump();
+        if (snapshots.update() && snapshots.read().run == run.run && !select_stage)
+        {
+            HullSnapshot &s = snapshots.read();
+            upper_hull.upper_edges.swap(s.upper_edges);
+            lower_hull.lower_edges.swap(s.lower_edges);
+            upper_hull.curr_median = s.upper_median;
+            lower_hull.curr_median = s.lower_median;
+            upper_hull.xmin = s.upper_xmin;
+            upper_hull.xmax = s.upper_xmax;
+            lower_hull.xmin = s.lower_xmin;
+            lower_hull.xmax = s.lower_xmax;
+            over = s.over;
+            lower = s.lower;
+            first = s.first;
+        }
+        telemetry.mark(phase_compute);
 
         ClearBackground(green);
 
@@ -1311,15 +1456,18 @@ int main()
             {
                 DrawText("minimum 3 points to start ", 20, height - 45, 40, WHITE);
             }
+            DrawText(upper_hull.random_slope ? "bridge: random slope (M)" : "bridge: median slope (M)", width - 230, height - 30, 20, WHITE);
         }
 
         else if (over == 1 && !lower)
         {
             DrawText("hit enter to restart ", 20, height - 45, 40, WHITE);
             ///after calculating the upper and lower hull join xmin of both the hulls and then join xmax of both the hulls
-            DrawLine(upper_hull.xmin.x, upper_hull.xmin.y, lower_hull.xmin.x, lower_hull.xmin.y, WHITE);
+            view.begin();
+            DrawLineV(upper_hull.xmin, lower_hull.xmin, WHITE);
 
-            DrawLine(upper_hull.xmax.x, upper_hull.xmax.y, lower_hull.xmax.x, lower_hull.xmax.y, WHITE);
+            DrawLineV(upper_hull.xmax, lower_hull.xmax, WHITE);
+            view.end();
 
             if (IsKeyPressed(KEY_ENTER))
             {
@@ -1329,51 +1477,42 @@ int main()
                 upper_hull.upper_edges = {};
                 lower_hull.lower_edges = {};
                 points.points_location = {};
+                points.loaded_hull = {};
             }
 
             if(IsKeyPressed(KEY_R))
             {
-                over=0;
-                first = 1;
-                upper_hull.upper_edges = {};
-                lower_hull.lower_edges = {};
-
-                select_stage = 0;
-                xmin_upper = upper_hull.find_xmin(points.points_location);
-                xmax_upper = upper_hull.find_xmax(points.points_location);
-                struct info info_temp1;
-                info_temp1.left = xmin_upper;
-                info_temp1.right = xmax_upper;
-                info_temp1.points = points.points_location;
-                upper_hull.s.push_back(info_temp1);
-
-                xmin_lower = lower_hull.find_xmin(points.points_location);
-                xmax_lower = lower_hull.find_xmax(points.points_location);
-                struct info info_temp2;
-                info_temp2.left = xmin_lower;
-                info_temp2.right = xmax_lower;
-                info_temp2.points = points.points_location;
-                lower_hull.s.push_back(info_temp2);
-                time=1;
-
+                start_run();
             }
         }
         else if (lower == 0)
         {
             DrawText("upper hull", 20, height - 45, 40, WHITE);
-            DrawLine(upper_hull.curr_median.x, 0, upper_hull.curr_median.x, 500, BLACK);
+            Rectangle visible = view.visible();
+            view.begin();
+            DrawLineV({upper_hull.curr_median.x, visible.y}, {upper_hull.curr_median.x, visible.y + visible.height}, BLACK);
+            view.end();
         }
         else
         {
             DrawText("lower hull", 20, height - 45, 40, WHITE);
+            Rectangle visible = view.visible();
+            view.begin();
             if (!first)
-                DrawLine(lower_hull.curr_median.x, 0, lower_hull.curr_median.x, 500, BLACK);
+                DrawLineV({lower_hull.curr_median.x, visible.y}, {lower_hull.curr_median.x, visible.y + visible.height}, BLACK);
+            view.end();
         }
+        view.begin();
         points.draw();
         upper_hull.draw_upper();
         lower_hull.draw_lower();
+        view.end();
+        telemetry.draw(10, 10);
+        telemetry.mark(phase_draw);
 
         EndDrawing();
+        telemetry.mark(phase_present);
+        telemetry.end_frame();
     }
     CloseWindow();
     return 0;